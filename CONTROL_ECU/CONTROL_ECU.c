@@ -13,32 +13,44 @@
 #include <avr/io.h>
 #include <util/delay.h>
 #include "CONTROL_ECU.h"
+#include "board.h"
 #include "dcmotor.h"
+#include "motion.h"
+#include "position.h"
 #include "external_eeprom.h"
 #include "buzzer.h"
-#include "timer1.h"
 #include "uart.h"
 #include "twi.h"
+#include "timestamp.h"
+#include "sys_timer.h"
 #include <string.h>
 
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
 /*Flag that signals the completion of Timer 1 task in the code*/
-boolean g_timer_is_finished=FALSE;
+volatile boolean g_timer_is_finished=FALSE;
 
-/*Flag that indicates whether the timer is done with the delay or not*/
-boolean g_timer_delay_flag=FALSE;
+/*Seconds left of the lockout, 0 if the system isn't locked*/
+volatile uint8 g_lockout_seconds=0;
 
-/*Dummy Configuration Structure For TIMER1*/
-Timer1_ConfigType Timer1_Config_Struct={
-		0,1,NO_PRESCALER,TIMER1_COMPARE_MODE
-};
+/*
+ * Door states posted by the door call back, waiting to be reported to the HMI ECU by the main context.
+ * A stage may end before the main context reported the previous one, so they're queued.
+ */
+volatile Door_Event g_door_events[DOOR_EVENT_QUEUE_SIZE];
+volatile uint8 g_door_events_head=0;
+volatile uint8 g_door_events_tail=0;
 
-/*Timer configuration structure to be used as a delay*/
-Timer1_ConfigType Timer1_Delay_Struct={
-		0,58594,F_CPU_1024,TIMER1_COMPARE_MODE
+/*Flag set by the door call back after starting the closing travel, the main context checks the closed end stop*/
+volatile boolean g_door_check_reached=FALSE;
+
+/*Motion profile of the door travel, the same in both directions*/
+static const Motion_ProfileType g_doorProfile={
+		DOOR_MOTION_TIME_MS,DOOR_ACCEL_TIME_MS,DOOR_DECEL_TIME_MS,DOOR_APPROACH_TIME_MS,DOOR_OVERRUN_TIME_MS,
+		DOOR_CRUISE_DUTY,DOOR_APPROACH_DUTY
 };
+
 /*******************************************************************************
  *                      Main Function Definition                               *
  *******************************************************************************/
@@ -76,11 +88,21 @@ int main(void)
 	/*Counter to count the number of failed attempts during entering the password to open the door or changing the password*/
 	uint8 wrongPass_counter=0;
 
+	/*Copy of the lockout seconds left, the lockout timer counts them down from its ISR*/
+	uint8 lockout_seconds;
+
+	/*Variable to store the SREG value, to restore the I-bit after taking the copy*/
+	uint8 sreg_value;
+
 	/********************HARDWARE INITIALIZATIONS********************/
+	Board_init();
 	UART_init(&UART_Config_Struct);
 	TWI_init(&TWI_Config_Struct);
 	DcMotor_init();
 	Buzzer_init();
+	Timestamp_init();
+	SysTimer_init();
+	Position_init();
 
 	/*Enable The global interrupts (I-bit)*/
 	SREG|=(1<<7);
@@ -119,7 +141,24 @@ int main(void)
 		/*Step 2: Receive the choice picked by the user from the Main Options (+: open door, -: change password)*/
 		optionStep_choice=UART_recieveByte();
 
-		if(optionStep_choice=='+')
+		/*The check and the reply use the same copy, so the lockout can't end between them*/
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+		lockout_seconds=g_lockout_seconds;
+		SREG=sreg_value;
+
+		if(lockout_seconds!=0)
+		{
+			/*During the lockout every request is answered at once with the seconds left, and nothing else is done*/
+			UART_sendByte(LOCKOUT_ACTIVE);
+			UART_sendByte(lockout_seconds);
+		}
+		else if(optionStep_choice==LOCKOUT_STATUS_REQUEST)
+		{
+			/*The system isn't locked*/
+			UART_sendByte(LOCKOUT_INACTIVE);
+		}
+		else if(optionStep_choice=='+')
 		{
 
 			/*If the user wants to open the door, ask him to enter the saved password in the EEPROM*/
@@ -174,32 +213,37 @@ int main(void)
 				/*
 				 * If the user entered wrong password 3 consecutive times:
 				 * 1- Alert HMI ECU to display Error message on LCD.
-				 * 2- Activate the buzzer for 1 Minute
+				 * 2- Lock the system for 1 Minute, the requests are still answered meanwhile.
 				 */
-				Buzzer_on();
-
-				/*Start the timer to count 1 minute*/
-				Timer1_setCallBack(callBack);
-				Timer1_init(&Timer1_Delay_Struct);
-				g_timer_delay_flag=TRUE;
-
-				/*Wait until the timer is done*/
-				while(g_timer_delay_flag==TRUE);
-
-				/*Turn Off The Buzzer*/
-				Buzzer_off();
+				startLockout();
 			}
 			else if(pass_state==PASSWORD_PASSED)
 			{
 				/*
-				 * If the user entered the correct password, initiate the timer with dummy configurations to
-				 * call the callBack function that controls the opening and closing of the motor.
+				 * If the user entered the correct password, start opening the door, then the end of the travel
+				 * calls the door call back function that controls the rest of the motor motion.
 				 */
-				Timer1_setCallBack(callBack);
-				Timer1_init(&Timer1_Config_Struct);
+				Motion_start(POSITION_OPEN_DIRECTION, &g_doorProfile, doorCallBack, NULL_PTR);
+				Position_checkReached();
 
-				/*Wait until the timer is done opening and closing the door (MOTOR)*/
-				while(!g_timer_is_finished);
+				/*
+				 * Sleep until the door is done opening and closing (MOTOR), the stages take as long as the
+				 * mechanism needs, so each one is reported to the HMI ECU when it ends.
+				 */
+				while(!g_timer_is_finished)
+				{
+					/*A closing travel starting at the closed end stop gets no switch edge, it's ended here*/
+					if(g_door_check_reached)
+					{
+						g_door_check_reached=FALSE;
+						Position_checkReached();
+					}
+					reportDoorState();
+					SysTimer_idle();
+				}
+
+				/*Report the last stage, posted together with the end of the cycle*/
+				reportDoorState();
 
 				/*Reset the flag*/
 				g_timer_is_finished=FALSE;
@@ -261,20 +305,9 @@ int main(void)
 				/*
 				 * If the user entered wrong password 3 consecutive times:
 				 * 1- Alert HMI ECU to display Error message on LCD.
-				 * 2- Activate the buzzer for 1 Minute
+				 * 2- Lock the system for 1 Minute, the requests are still answered meanwhile.
 				 */
-				Buzzer_on();
-
-				/*Start the timer to count 1 minute*/
-				Timer1_setCallBack(callBack);
-				Timer1_init(&Timer1_Delay_Struct);
-				g_timer_delay_flag=TRUE;
-
-				/*Wait until the timer is done*/
-				while(g_timer_delay_flag==TRUE);
-
-				/*Turn Off The Buzzer*/
-				Buzzer_off();
+				startLockout();
 			}
 			else if(pass_state==PASSWORD_PASSED)
 			{
@@ -400,138 +433,126 @@ Password_Status confirmPassword(uint8*pass_one)
 
 /*
  * Description :
- * This is the callBack Function that'll be called when an interrupt request is generated
- * by Timer1.
+ * This function takes the door states posted by the door call back and reports them to the HMI ECU in order.
+ * It runs in the main context, so the UART never blocks the call back.
  */
-void callBack(void)
+void reportDoorState(void)
 {
-	/*Interrupt counter, used in time calculations*/
-	static uint8 interrupt_counter=0;
-
-	/*A variable to store which stage of motor rotation we'r in*/
-	static sint8 state_counter=1;
-
-	/*Flag to execute the initializations of the timer only once when this function is first called*/
-	static boolean init1_flag=TRUE;
+	/*Variable to store the taken door event*/
+	Door_Event event;
 
-	/*Ask whether we want to use timer as delay to activate buzzer, or use it to count time of motor opening and closing*/
-	if(g_timer_delay_flag==TRUE)
+	/*Only the main context moves the tail, the call back only moves the head after writing its event*/
+	while(g_door_events_tail!=g_door_events_head)
 	{
-		/*If we use timer as delay increment the counter till it reaches 8, .i.e, a minute has passed*/
-		interrupt_counter++;
-		if(interrupt_counter==8)
-		{
-			/*After one minute, reset every thing*/
+		event=g_door_events[g_door_events_tail];
+		g_door_events_tail=(g_door_events_tail+1)&(DOOR_EVENT_QUEUE_SIZE-1);
+		UART_sendByte(event);
+	}
+}
 
-			/*Turn off the flag to stop the polling in the main program*/
-			g_timer_delay_flag=FALSE;
-			Timer1_deInit();
-			interrupt_counter=0;
-		}
+/*
+ * Description :
+ * This function queues a door state to be reported to the HMI ECU by the main context.
+ * It's called by the door call back from the ISRs, and from the main context when Position_checkReached
+ * ends a travel, so the queue is updated with the interrupts disabled.
+ * The queue holds more than the events of one cycle, and the main context empties it between the cycles.
+ */
+void postDoorEvent(Door_Event event)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value;
+
+	/*Next head of the queue*/
+	uint8 next;
 
+	sreg_value=SREG;
+	SREG&=~(1<<7);
+	next=(g_door_events_head+1)&(DOOR_EVENT_QUEUE_SIZE-1);
+	if(next==g_door_events_tail)
+	{
+		/*Do Nothing*/
 	}
 	else
 	{
-		/*switch to execute the proper stage code*/
-		switch (state_counter)
-		{
-		case 1:
-			if(init1_flag==TRUE)
-			{
-				/*If the flag is 1, it means it's the first time to call this function, hence we need to execute the initializations*/
-
-				/*Turn off the flag, to prevent multiple configuration setup*/
-				init1_flag=FALSE;
-
-				/*start the motor, .i.e, open the door*/
-				DcMotor_Rotate(CW, 100);
-
-				/*start the timer to count 15 seconds*/
-				Timer1_Config_Struct.mode=TIMER1_COMPARE_MODE;
-				Timer1_Config_Struct.prescaler=F_CPU_1024;
-				Timer1_Config_Struct.compare_value=60000;
-				Timer1_Config_Struct.initial_value=0;
-				Timer1_init(&Timer1_Config_Struct);
-
-				/*Break out of the switch after configuring the timer for the first time*/
-				break;
-			}
-			else
-			{
-				/*Do Nothing*/
-			}
-
-			/*increment the counter because 15 seconds means approximately 2 compare matches of the timer*/
-			interrupt_counter++;
-
-			if(interrupt_counter==2)
-			{
-				/*After 15 seconds, reset the counter and turn off the motor*/
-				interrupt_counter=0;
-				DcMotor_Rotate(STOP, 0);
-
-				/*change motor state, hold for 3 seconds*/
-				state_counter++;
-
-				/*configure the timer to count 3 seconds*/
-				Timer1_Config_Struct.compare_value=23438;
-				Timer1_Config_Struct.initial_value=0;
-				Timer1_init(&Timer1_Config_Struct);
-			}
-			else
-			{
-				/*Do Nothing*/
-			}
-			break;
-		case 2:
-			/*After 3 seconds, rotate the motor in the opposite direction for 15 more seconds*/
-			/*reset the counter*/
-			interrupt_counter=0;
-			DcMotor_Rotate(CCW, 100);
-
-			/*Increment to call back reset stage*/
-			state_counter++;
-
-			/*Configure the timer to count 15 seconds*/
-			Timer1_Config_Struct.compare_value=60000;
-			Timer1_Config_Struct.initial_value=0;
-			Timer1_init(&Timer1_Config_Struct);
-			break;
-		case 3:
-			/*increment the counter because 15 seconds means approximately 2 compare matches of the timer*/
-			interrupt_counter++;
-
-			if(interrupt_counter==2)
-			{
-				/*After 15 seconds, .i.e, door is closed, reset the call back function for next usage*/
-				interrupt_counter=0;
+		g_door_events[g_door_events_head]=event;
+		g_door_events_head=next;
+	}
+	SREG=sreg_value;
+}
 
-				/*Turn off the motor*/
-				DcMotor_Rotate(STOP, 0);
+/*
+ * Description :
+ * This is the call back function of the door timer and the door motion, it controls the door cycle:
+ * opening until the open end stop, holding for 3 seconds then closing until the closed end stop.
+ * The motion profile stops the motor at the end of each travel before calling it.
+ */
+void doorCallBack(void *context)
+{
+	/*A variable to store which stage of motor rotation we'r in*/
+	static sint8 state_counter=1;
 
-				/*Back to state 1*/
-				state_counter=1;
+	/*switch to execute the proper stage code*/
+	switch (state_counter)
+	{
+	case 1:
+		/*The door is open, hold for 3 seconds*/
+		state_counter++;
+		postDoorEvent(DOOR_UNLOCKED);
+		SysTimer_start(SYS_TIMER_DOOR, SYS_TIMER_MS_TO_TICKS(DOOR_HOLD_TIME_MS), 0, doorCallBack, NULL_PTR);
+		break;
+	case 2:
+		/*After 3 seconds, rotate the motor in the opposite direction until the door is closed*/
+		state_counter++;
+		postDoorEvent(DOOR_LOCKING);
+		Motion_start(POSITION_CLOSE_DIRECTION, &g_doorProfile, doorCallBack, NULL_PTR);
+
+		/*This runs in the timer ISR, the closed end stop is checked by the main context*/
+		g_door_check_reached=TRUE;
+		break;
+	case 3:
+		/*The door is closed*/
+
+		/*Back to state 1*/
+		state_counter=1;
+		postDoorEvent(DOOR_LOCKED);
+
+		/*Global timer flag is enabled to signal that the program is permitted to execute other instructions, .i.e, system unlocked*/
+		g_timer_is_finished=TRUE;
+		break;
+	}
+}
 
-				/*Re-enable first configuration flag*/
-				init1_flag=TRUE;
+/*
+ * Description :
+ * This function starts the 1 minute lockout after three wrong passwords, it returns at once.
+ * The alarm plays in the background and the requests get the seconds left until the lockout is over.
+ */
+void startLockout(void)
+{
+	Buzzer_play(BUZZER_PATTERN_ALARM);
 
-				/*Dummy configurations*/
-				Timer1_Config_Struct.compare_value=1;
-				Timer1_Config_Struct.initial_value=0;
-				Timer1_Config_Struct.mode=TIMER1_COMPARE_MODE;
-				Timer1_Config_Struct.prescaler=NO_PRESCALER;
+	/*Count the lockout down every second*/
+	g_lockout_seconds=LOCKOUT_TIME_MS/1000;
+	SysTimer_start(SYS_TIMER_LOCKOUT, SYS_TIMER_MS_TO_TICKS(1000), SYS_TIMER_MS_TO_TICKS(1000), lockoutCallBack, NULL_PTR);
+}
 
-				/*Global timer flag is enabled to signal that the program is permitted to execute other instructions, .i.e, system unlocked*/
-				g_timer_is_finished=TRUE;
+/*
+ * Description :
+ * This is the call back function of the lockout timer, it counts the lockout seconds down and ends
+ * the buzzer alarm when they're over.
+ */
+void lockoutCallBack(void *context)
+{
+	g_lockout_seconds--;
 
-				/*Disable the timer*/
-				Timer1_deInit();
-			}
-			else
-			{
-				/*Do Nothing*/
-			}
-			break;
-		}
+	if(g_lockout_seconds==0)
+	{
+		/*The lockout is over, stop the timer and turn off the buzzer*/
+		SysTimer_stop(SYS_TIMER_LOCKOUT);
+		Buzzer_off();
+	}
+	else
+	{
+		/*Do Nothing*/
 	}
 }
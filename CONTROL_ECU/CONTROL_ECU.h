@@ -21,6 +21,36 @@
  *******************************************************************************/
 #define F_CPU 8000000UL
 
+/*Durations in milliseconds of the system timer tasks*/
+#define DOOR_MOTION_TIME_MS		15000
+#define DOOR_HOLD_TIME_MS		3000
+#define LOCKOUT_TIME_MS			60000
+
+/*Door events waiting to be reported, a power of 2 larger than the events of one door cycle*/
+#define DOOR_EVENT_QUEUE_SIZE	4
+
+/*Request of the lockout state, it's answered at once even during the lockout*/
+#define LOCKOUT_STATUS_REQUEST	'?'
+
+#if ((LOCKOUT_TIME_MS/1000) > 255)
+#error "The lockout seconds left should fit in one UART byte"
+#endif
+
+/*
+ * Motion profile of the door, the travel takes DOOR_MOTION_TIME_MS in each direction or less if an end stop
+ * switch is reached earlier. Without a switch the approach goes on for DOOR_OVERRUN_TIME_MS more at most.
+ */
+#define DOOR_OVERRUN_TIME_MS	3000
+#define DOOR_ACCEL_TIME_MS		1000
+#define DOOR_DECEL_TIME_MS		1000
+#define DOOR_APPROACH_TIME_MS	1500
+#define DOOR_CRUISE_DUTY		255 /*100%*/
+#define DOOR_APPROACH_DUTY		102 /*40%*/
+
+#if ((DOOR_ACCEL_TIME_MS+DOOR_DECEL_TIME_MS+DOOR_APPROACH_TIME_MS) > DOOR_MOTION_TIME_MS)
+#error "The door motion profile phases don't fit in the door motion time"
+#endif
+
 /*******************************************************************************
  *                         Types Declaration                                   *
  *******************************************************************************/
@@ -28,6 +58,23 @@ typedef enum{
 	PASSWORD_FAILED,PASSWORD_PASSED,THIEF
 }Password_Status;
 
+/*
+ * Lockout state replied to the requests, LOCKOUT_ACTIVE is followed by the seconds left.
+ * The codes differ from the password states and the door states, so a lockout reply read where a password
+ * state is expected is never taken for PASSWORD_PASSED.
+ */
+typedef enum{
+	LOCKOUT_INACTIVE=0xA0,LOCKOUT_ACTIVE=0xA1
+}Lockout_Status;
+
+/*
+ * Door states reported to the HMI ECU at the end of each stage of the door cycle.
+ * The codes differ from the password and lockout states, so a late report is never taken for the reply of a request.
+ */
+typedef enum{
+	DOOR_NO_EVENT=0xB0,DOOR_UNLOCKING,DOOR_UNLOCKED,DOOR_LOCKING,DOOR_LOCKED
+}Door_Event;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
@@ -59,9 +106,36 @@ Password_Status confirmPassword(uint8*pass_one);
 
 /*
  * Description :
- * This is the callBack Function that'll be called when an interrupt request is generated
- * by Timer1.
+ * This function takes the door states posted by the door call back and reports them to the HMI ECU in order.
+ * It runs in the main context, so the UART never blocks the call back.
+ */
+void reportDoorState(void);
+
+/*
+ * Description :
+ * This function queues a door state to be reported to the HMI ECU by the main context.
+ */
+void postDoorEvent(Door_Event event);
+
+/*
+ * Description :
+ * This is the call back function of the door timer and the door motion, it controls the door cycle:
+ * opening until the open end stop, holding for 3 seconds then closing until the closed end stop.
+ */
+void doorCallBack(void *context);
+
+/*
+ * Description :
+ * This function starts the 1 minute lockout after three wrong passwords, it returns at once.
+ * The alarm plays in the background and the requests get the seconds left until the lockout is over.
+ */
+void startLockout(void);
+
+/*
+ * Description :
+ * This is the call back function of the lockout timer, it counts the lockout seconds down and ends
+ * the buzzer alarm when they're over.
  */
-void callBack(void);
+void lockoutCallBack(void *context);
 
 #endif /* CONTROL_ECU_H_ */
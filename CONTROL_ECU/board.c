@@ -0,0 +1,98 @@
+/******************************************************************************
+ *
+ * Module: Board
+ *
+ * File Name: board.c
+ *
+ * Description: Source file for the boot pin configuration of the Control ECU board
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "board.h"
+#include "buzzer.h" /*To use the buzzer off level*/
+#include <avr/io.h> /*To use the IO Ports Registers*/
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Pin directions in the board table, the GPIO enums can't be used in the preprocessor checks*/
+#define BOARD_INPUT					0
+#define BOARD_OUTPUT				1
+
+/*The encoder pins are in the table only if the encoder is fitted*/
+#if (DOOR_ENCODER_CONNECTED == TRUE)
+#define BOARD_ENCODER_MASK(pin_num)	(1<<(pin_num))
+#else
+#define BOARD_ENCODER_MASK(pin_num)	0
+#endif
+
+/*
+ * Board table, one entry for every pin or group of pins of one port:
+ * X(port, port id, pins mask, direction, level)
+ * The level of an output pin is its boot value, a high level on an input pin enables its pull-up.
+ * It's expanded once per port, the entries of other ports add nothing to the result.
+ */
+#define BOARD_PINS(X,port) \
+	X(port, DC_MOTOR_IN1_PORT_ID, (1<<DC_MOTOR_IN1_PIN_ID), BOARD_OUTPUT, LOGIC_LOW) \
+	X(port, DC_MOTOR_IN2_PORT_ID, (1<<DC_MOTOR_IN2_PIN_ID), BOARD_OUTPUT, LOGIC_LOW) \
+	X(port, PWM_OC0_PORT_ID, (1<<PWM_OC0_PIN_ID), BOARD_OUTPUT, LOGIC_LOW) \
+	X(port, BUZZER_CNTRL_PORT_ID, (1<<BUZZER_CNTRL_PIN_ID), BOARD_OUTPUT, BUZZER_OFF) \
+	X(port, DOOR_OPEN_LIMIT_PORT_ID, (1<<DOOR_OPEN_LIMIT_PIN_ID), BOARD_INPUT, LOGIC_HIGH) \
+	X(port, DOOR_CLOSED_LIMIT_PORT_ID, (1<<DOOR_CLOSED_LIMIT_PIN_ID), BOARD_INPUT, LOGIC_HIGH) \
+	X(port, DOOR_ENCODER_A_PORT_ID, BOARD_ENCODER_MASK(DOOR_ENCODER_A_PIN_ID), BOARD_INPUT, LOGIC_HIGH) \
+	X(port, DOOR_ENCODER_B_PORT_ID, BOARD_ENCODER_MASK(DOOR_ENCODER_B_PIN_ID), BOARD_INPUT, LOGIC_HIGH) \
+	X(port, UART_RXD_PORT_ID, (1<<UART_RXD_PIN_ID), BOARD_INPUT, LOGIC_LOW) \
+	X(port, UART_TXD_PORT_ID, (1<<UART_TXD_PIN_ID), BOARD_OUTPUT, LOGIC_HIGH) \
+	X(port, TWI_SCL_PORT_ID, (1<<TWI_SCL_PIN_ID), BOARD_INPUT, LOGIC_LOW) \
+	X(port, TWI_SDA_PORT_ID, (1<<TWI_SDA_PIN_ID), BOARD_INPUT, LOGIC_LOW)
+
+/*Table entry helpers, each one returns the mask of the entry if it's on the required port*/
+#define BOARD_SUM_MASK(port,port_num,mask,direction,level)     +(((port_num) == (port)) ? (mask) : 0)
+#define BOARD_OR_MASK(port,port_num,mask,direction,level)      |(((port_num) == (port)) ? (mask) : 0)
+#define BOARD_DDR_MASK(port,port_num,mask,direction,level)     |((((port_num) == (port)) && ((direction) == BOARD_OUTPUT)) ? (mask) : 0)
+#define BOARD_PORT_MASK(port,port_num,mask,direction,level)    |((((port_num) == (port)) && ((level) == LOGIC_HIGH)) ? (mask) : 0)
+
+/*Pins used on a port, the sum equals the mask only if no pin is assigned twice*/
+#define BOARD_USED_SUM(port)        (0 BOARD_PINS(BOARD_SUM_MASK,port))
+#define BOARD_USED_MASK(port)       (0 BOARD_PINS(BOARD_OR_MASK,port))
+
+/*Boot values of the port registers, the unused pins are inputs without pull-up*/
+#define BOARD_DDR_VALUE(port)       (0 BOARD_PINS(BOARD_DDR_MASK,port))
+#define BOARD_PORT_VALUE(port)      (0 BOARD_PINS(BOARD_PORT_MASK,port))
+
+/*******************************************************************************
+ *                      Preprocessor Error                                     *
+ *******************************************************************************/
+#if ((BOARD_USED_SUM(PORTA_ID) != BOARD_USED_MASK(PORTA_ID)) || (BOARD_USED_SUM(PORTB_ID) != BOARD_USED_MASK(PORTB_ID)) || \
+	 (BOARD_USED_SUM(PORTC_ID) != BOARD_USED_MASK(PORTC_ID)) || (BOARD_USED_SUM(PORTD_ID) != BOARD_USED_MASK(PORTD_ID)))
+#error "A pin is assigned to more than one function in board.h"
+#endif
+
+#if ((BOARD_USED_MASK(PORTA_ID) | BOARD_USED_MASK(PORTB_ID) | BOARD_USED_MASK(PORTC_ID) | BOARD_USED_MASK(PORTD_ID)) > 0xFF)
+#error "A pin number in board.h is out of range"
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to set the boot direction and level of every pin of the board.
+ * The PORT register is written before the DDR register, so an output pin starts at its level.
+ */
+void Board_init(void)
+{
+	PORTA=BOARD_PORT_VALUE(PORTA_ID);
+	DDRA=BOARD_DDR_VALUE(PORTA_ID);
+	PORTB=BOARD_PORT_VALUE(PORTB_ID);
+	DDRB=BOARD_DDR_VALUE(PORTB_ID);
+	PORTC=BOARD_PORT_VALUE(PORTC_ID);
+	DDRC=BOARD_DDR_VALUE(PORTC_ID);
+	PORTD=BOARD_PORT_VALUE(PORTD_ID);
+	DDRD=BOARD_DDR_VALUE(PORTD_ID);
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+ *
+ * Module: Board
+ *
+ * File Name: board.h
+ *
+ * Description: Pin assignments of the Control ECU board
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef BOARD_H_
+#define BOARD_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+#include "gpio.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*
+ * Every pin used on the board is assigned here, the drivers take their pins from this file.
+ * The boot direction and level of each pin are listed in the board table in board.c.
+ */
+
+/*DC motor H-bridge inputs, the enable input is driven by the OC0 output of Timer0*/
+#define DC_MOTOR_IN1_PORT_ID 		PORTB_ID
+#define DC_MOTOR_IN1_PIN_ID 		PIN0_ID
+#define DC_MOTOR_IN2_PORT_ID		PORTB_ID
+#define DC_MOTOR_IN2_PIN_ID			PIN1_ID
+#define DC_MOTOR_EN_PORT_ID			PORTB_ID
+#define DC_MOTOR_EN_PIN_ID			PIN3_ID
+
+/*Buzzer control pin*/
+#define BUZZER_CNTRL_PORT_ID		PORTD_ID
+#define BUZZER_CNTRL_PIN_ID			PIN6_ID
+
+/*Door end stop switches, each one closes to ground at its end of the travel and wakes its external interrupt*/
+#define DOOR_OPEN_LIMIT_PORT_ID		PORTD_ID
+#define DOOR_OPEN_LIMIT_PIN_ID		PIN2_ID
+#define DOOR_CLOSED_LIMIT_PORT_ID	PORTD_ID
+#define DOOR_CLOSED_LIMIT_PIN_ID	PIN3_ID
+
+/*
+ * Optional quadrature encoder on the door mechanism, set to FALSE if it isn't fitted.
+ * Channel A interrupts on INT2, channel B is read in the ISR to get the direction.
+ */
+#define DOOR_ENCODER_CONNECTED		FALSE
+#define DOOR_ENCODER_A_PORT_ID		PORTB_ID
+#define DOOR_ENCODER_A_PIN_ID		PIN2_ID
+#define DOOR_ENCODER_B_PORT_ID		PORTB_ID
+#define DOOR_ENCODER_B_PIN_ID		PIN4_ID
+
+/*Pins fixed by the MCU peripherals, listed to catch any other use of them*/
+#define PWM_OC0_PORT_ID				PORTB_ID
+#define PWM_OC0_PIN_ID				PIN3_ID
+#define UART_RXD_PORT_ID			PORTD_ID
+#define UART_RXD_PIN_ID				PIN0_ID
+#define UART_TXD_PORT_ID			PORTD_ID
+#define UART_TXD_PIN_ID				PIN1_ID
+#define TWI_SCL_PORT_ID				PORTC_ID
+#define TWI_SCL_PIN_ID				PIN0_ID
+#define TWI_SDA_PORT_ID				PORTC_ID
+#define TWI_SDA_PIN_ID				PIN1_ID
+
+#if ((DC_MOTOR_EN_PORT_ID != PWM_OC0_PORT_ID) || (DC_MOTOR_EN_PIN_ID != PWM_OC0_PIN_ID))
+#error "The DC motor enable input should be connected to the OC0 pin"
+#endif
+
+#if ((DOOR_OPEN_LIMIT_PORT_ID != PORTD_ID) || (DOOR_OPEN_LIMIT_PIN_ID != PIN2_ID) || \
+	 (DOOR_CLOSED_LIMIT_PORT_ID != PORTD_ID) || (DOOR_CLOSED_LIMIT_PIN_ID != PIN3_ID))
+#error "The door open and closed limit switches should be connected to the INT0 and INT1 pins"
+#endif
+
+#if ((DOOR_ENCODER_CONNECTED == TRUE) && ((DOOR_ENCODER_A_PORT_ID != PORTB_ID) || (DOOR_ENCODER_A_PIN_ID != PIN2_ID)))
+#error "The door encoder channel A should be connected to the INT2 pin"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to set the boot direction and level of every pin of the board.
+ * The values are computed at compile time, each port costs one PORT store and one DDR store.
+ * It should be called first at boot, the drivers init functions don't configure their pins.
+ */
+void Board_init(void);
+
+#endif /* BOARD_H_ */
@@ -14,41 +14,151 @@
  *                                Includes                                     *
  *******************************************************************************/
 #include "buzzer.h"
+#include "sys_timer.h" /*To play the pattern steps*/
+#include <avr/pgmspace.h> /*To keep the patterns in the flash*/
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Step durations of the patterns in ticks, see BUZZER_PATTERN_END and BUZZER_PATTERN_REPEAT*/
+static const uint8 g_buzzerPatterns[BUZZER_NUM_OF_PATTERNS][BUZZER_PATTERN_LENGTH] PROGMEM = {
+		{25,25,BUZZER_PATTERN_REPEAT},				/*BUZZER_PATTERN_ALARM: 2 beeps per second*/
+		{2,BUZZER_PATTERN_END},						/*BUZZER_PATTERN_KEY_CLICK: one 20 ms click*/
+		{6,4,6,4,20,BUZZER_PATTERN_END},			/*BUZZER_PATTERN_SUCCESS: two short beeps then a long one*/
+		{5,195,BUZZER_PATTERN_REPEAT}				/*BUZZER_PATTERN_LOW_BATTERY: a short beep every 2 seconds*/
+};
+
+/*Pattern being played and its next step, the pattern is BUZZER_NUM_OF_PATTERNS if none is playing*/
+static volatile Buzzer_PatternId g_buzzerPattern=BUZZER_NUM_OF_PATTERNS;
+static uint8 g_buzzerStep;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Call back function of the buzzer system timer, it plays the next step of the pattern.
+ */
+static void Buzzer_stepCallBack(void *context);
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
 /*
  * Description :
- * 1) This function is responsible for setup the direction of the buzzer
- *    control pin.
- * 2) Turn off the buzzer at first, .i.e, OUTPUT LOGIC LOW.
+ * This function is responsible for turning off the buzzer at first, .i.e, OUTPUT LOGIC LOW.
+ * The direction of the buzzer control pin is set by Board_init.
  */
 void Buzzer_init(void)
 {
-	/*Setup the direction of the buzzer control pin*/
-	GPIO_setupPinDirection(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, PIN_OUTPUT);
-
 	/*Turn off the buzzer*/
-	GPIO_writePin(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_OFF);
+	GPIO_WRITE_PIN(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_OFF);
 }
 
 /*
  * Description :
- * Function to enable the buzzer through the GPIO.
+ * Function to enable the buzzer through the GPIO, with a solid tone. A running pattern is stopped.
  */
 void Buzzer_on(void)
 {
+	SysTimer_stop(SYS_TIMER_BUZZER);
+	g_buzzerPattern=BUZZER_NUM_OF_PATTERNS;
+
 	/*Turn on the buzzer*/
-	GPIO_writePin(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_ON);
+	GPIO_WRITE_PIN(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_ON);
 }
 
 /*
  * Description :
- * Function to disable the buzzer through the GPiO.
+ * Function to disable the buzzer through the GPiO. A running pattern is stopped.
  */
 void Buzzer_off(void)
 {
+	SysTimer_stop(SYS_TIMER_BUZZER);
+	g_buzzerPattern=BUZZER_NUM_OF_PATTERNS;
+
 	/*Turn off the buzzer*/
-	GPIO_writePin(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_OFF);
+	GPIO_WRITE_PIN(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_OFF);
+}
+
+/*
+ * Description :
+ * Function to start playing a pattern, it returns immediately and the steps are played by a system timer
+ * call back. A running pattern or solid tone is replaced.
+ */
+void Buzzer_play(Buzzer_PatternId pattern)
+{
+	if(pattern>=BUZZER_NUM_OF_PATTERNS)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		SysTimer_stop(SYS_TIMER_BUZZER);
+		g_buzzerPattern=pattern;
+		g_buzzerStep=0;
+
+		/*The first step is played at once, the call back plays the rest*/
+		Buzzer_stepCallBack(NULL_PTR);
+	}
+}
+
+/*
+ * Description :
+ * Function to check whether a pattern is playing or not, a repeating pattern plays until Buzzer_off.
+ */
+boolean Buzzer_isPlaying(void)
+{
+	return (g_buzzerPattern!=BUZZER_NUM_OF_PATTERNS);
+}
+
+/*
+ * Description :
+ * Call back function of the buzzer system timer, it plays the next step of the pattern.
+ * The even steps turn the buzzer on and the odd steps turn it off, each step arms the timer for its duration.
+ */
+static void Buzzer_stepCallBack(void *context)
+{
+	Buzzer_PatternId pattern=g_buzzerPattern;
+	uint8 duration;
+
+	if(pattern>=BUZZER_NUM_OF_PATTERNS)
+	{
+		return;
+	}
+
+	if(g_buzzerStep>=BUZZER_PATTERN_LENGTH)
+	{
+		duration=BUZZER_PATTERN_END;
+	}
+	else
+	{
+		duration=pgm_read_byte(&g_buzzerPatterns[pattern][g_buzzerStep]);
+	}
+
+	if(duration==BUZZER_PATTERN_REPEAT)
+	{
+		/*Start again, the patterns have an even number of steps before the repeat mark*/
+		g_buzzerStep=0;
+		duration=pgm_read_byte(&g_buzzerPatterns[pattern][0]);
+	}
+
+	if(duration==BUZZER_PATTERN_END)
+	{
+		/*End of the pattern*/
+		g_buzzerPattern=BUZZER_NUM_OF_PATTERNS;
+		GPIO_WRITE_PIN(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_OFF);
+	}
+	else
+	{
+		if((g_buzzerStep&1)==0)
+		{
+			GPIO_WRITE_PIN(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_ON);
+		}
+		else
+		{
+			GPIO_WRITE_PIN(BUZZER_CNTRL_PORT_ID, BUZZER_CNTRL_PIN_ID, BUZZER_OFF);
+		}
+		g_buzzerStep++;
+		SysTimer_start(SYS_TIMER_BUZZER,SYS_TIMER_MS_TO_TICKS((uint16)duration*BUZZER_TICK_MS),0,Buzzer_stepCallBack,NULL_PTR);
+	}
 }
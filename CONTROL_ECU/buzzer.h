@@ -18,37 +18,66 @@
  *******************************************************************************/
 #include "std_types.h"
 #include "gpio.h"
+#include "board.h" /*The buzzer pin is assigned in the board description*/
 
 /*******************************************************************************
  *                      Preprocessor Macros                                    *
  *******************************************************************************/
-#define BUZZER_CNTRL_PORT_ID		PORTD_ID
-#define BUZZER_CNTRL_PIN_ID			PIN6_ID
-
 #define BUZZER_ON					LOGIC_HIGH
 #define BUZZER_OFF					LOGIC_LOW
 
+/*Time unit of the pattern steps in milliseconds*/
+#define BUZZER_TICK_MS				10
+
+/*
+ * Patterns are sequences of step durations in ticks, alternating on and off and starting with on.
+ * A sequence ends with BUZZER_PATTERN_END to stop, or with BUZZER_PATTERN_REPEAT to play again from the start.
+ */
+#define BUZZER_PATTERN_END			0
+#define BUZZER_PATTERN_REPEAT		255
+#define BUZZER_PATTERN_LENGTH		8
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum{
+	BUZZER_PATTERN_ALARM,BUZZER_PATTERN_KEY_CLICK,BUZZER_PATTERN_SUCCESS,BUZZER_PATTERN_LOW_BATTERY,
+	BUZZER_NUM_OF_PATTERNS
+}Buzzer_PatternId;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 /*
  * Description :
- * 1) This function is responsible for setup the direction of the buzzer
- *    control pin.
- * 2) Turn off the buzzer at first, .i.e, OUTPUT LOGIC LOW.
+ * This function is responsible for turning off the buzzer at first, .i.e, OUTPUT LOGIC LOW.
+ * The direction of the buzzer control pin is set by Board_init.
  */
 void Buzzer_init(void);
 
 /*
  * Description :
- * Function to enable the buzzer through the GPIO.
+ * Function to enable the buzzer through the GPIO, with a solid tone. A running pattern is stopped.
  */
 void Buzzer_on(void);
 
 /*
  * Description :
- * Function to disable the buzzer through the GPiO.
+ * Function to disable the buzzer through the GPiO. A running pattern is stopped.
  */
 void Buzzer_off(void);
 
+/*
+ * Description :
+ * Function to start playing a pattern, it returns immediately and the steps are played by a system timer
+ * call back. A running pattern or solid tone is replaced.
+ */
+void Buzzer_play(Buzzer_PatternId pattern);
+
+/*
+ * Description :
+ * Function to check whether a pattern is playing or not, a repeating pattern plays until Buzzer_off.
+ */
+boolean Buzzer_isPlaying(void);
+
 #endif /* BUZZER_H_ */
@@ -12,21 +12,37 @@
 #include "dcmotor.h"
 #include "pwm.h" /*To be able to control the motor speed via generating a suitable waveform*/
 
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+#if (DC_MOTOR_IN1_PORT_ID == DC_MOTOR_IN2_PORT_ID)
+/*
+ * The two control pins share one port, so they are changed together in one register write
+ * and the H-bridge never sees an intermediate state between two motion states.
+ */
+#define DC_MOTOR_IN_MASK			((1<<DC_MOTOR_IN1_PIN_ID)|(1<<DC_MOTOR_IN2_PIN_ID))
+#define DC_MOTOR_STOP_VALUE			0
+#define DC_MOTOR_CW_VALUE			(1<<DC_MOTOR_IN1_PIN_ID)
+#define DC_MOTOR_CCW_VALUE			(1<<DC_MOTOR_IN2_PIN_ID)
+#endif
+
+/*Time taken by the motor to reach the required speed from standstill*/
+#define DC_MOTOR_RAMP_TIME_MS		500
+
 /*
  * Description :
- * This function is responsible for setting up the direction of the two motor pins
- * via GPIO driver.
- * It also configure the motor to be off at the beginning via GPIO driver.
+ * This function is responsible for configuring the motor to be off at the beginning via GPIO driver.
+ * The direction of the two motor pins is set by Board_init.
  */
 void DcMotor_init(void)
 {
-	/*Setup the two control pins of the motor as output pins*/
-	GPIO_setupPinDirection(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,PIN_OUTPUT);
-
 	/*Output 0 to the two pins to STOP the motor*/
-	GPIO_writePin(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,LOGIC_LOW);
-	GPIO_writePin(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,LOGIC_LOW);
+#if (DC_MOTOR_IN1_PORT_ID == DC_MOTOR_IN2_PORT_ID)
+	GPIO_WRITE_MASKED(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN_MASK,DC_MOTOR_STOP_VALUE);
+#else
+	GPIO_WRITE_PIN(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,LOGIC_LOW);
+	GPIO_WRITE_PIN(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,LOGIC_LOW);
+#endif
 
 }
 /*
@@ -36,34 +52,85 @@ void DcMotor_init(void)
  * It also handles the speed of the motor via sending the required speed
  * percentage to the PWM driver to output the required analog signal
  * to the motor.
+ * STOP removes the drive at once, CW and CCW start from standstill and ramp the speed
+ * over DC_MOTOR_RAMP_TIME_MS so the motor doesn't draw the full stall current.
  */
 void DcMotor_Rotate(DcMotor_State state,uint8 speed)
 {
+	/*Set the direction with the drive removed*/
+	DcMotor_drive(state,0);
+
+	/*Ramp Timer0 to the required speed to generate the required PWM on OC0 pin*/
+	if(state==STOP)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		PWM_Timer0_ramp(PWM_percentToDuty(speed),DC_MOTOR_RAMP_TIME_MS);
+	}
+}
+
+/*
+ * Description :
+ * This function sets the state of the motion and the raw duty cycle (0 --> PWM_MAX_DUTY) at once, without a ramp.
+ * The drive is removed before the control pins change, the duty is ignored in the STOP state.
+ * It's used by the layers that shape the speed themselves, like the motion profile.
+ */
+void DcMotor_drive(DcMotor_State state,uint8 duty)
+{
+	/*Remove the drive before changing the direction pins*/
+	PWM_Timer0_setDuty(0);
+
 	/*Output the state to the two control pins of the motor
 	 * 0 -> STOP
 	 * 1 -> CW
 	 * 2 -> CCW
 	 */
+#if (DC_MOTOR_IN1_PORT_ID == DC_MOTOR_IN2_PORT_ID)
 	switch (state)
 	{
 	case 0:
-		GPIO_writePin(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,LOGIC_LOW);
-		GPIO_writePin(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,LOGIC_LOW);
+		GPIO_WRITE_MASKED(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN_MASK,DC_MOTOR_STOP_VALUE);
 		break;
 	case 1:
-		GPIO_writePin(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,LOGIC_HIGH);
-		GPIO_writePin(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,LOGIC_LOW);
+		GPIO_WRITE_MASKED(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN_MASK,DC_MOTOR_CW_VALUE);
 		break;
 	case 2:
-		GPIO_writePin(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,LOGIC_HIGH);
-		GPIO_writePin(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,LOGIC_LOW);
+		GPIO_WRITE_MASKED(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN_MASK,DC_MOTOR_CCW_VALUE);
 		break;
 	default:
 		/*Do Nothing*/
 		break;
 	}
+#else
+	/*The pins are on two ports, the low pin is always written first so a reversal passes by STOP not brake*/
+	switch (state)
+	{
+	case 0:
+		GPIO_WRITE_PIN(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,LOGIC_LOW);
+		GPIO_WRITE_PIN(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,LOGIC_LOW);
+		break;
+	case 1:
+		GPIO_WRITE_PIN(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,LOGIC_LOW);
+		GPIO_WRITE_PIN(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,LOGIC_HIGH);
+		break;
+	case 2:
+		GPIO_WRITE_PIN(DC_MOTOR_IN1_PORT_ID,DC_MOTOR_IN1_PIN_ID,LOGIC_LOW);
+		GPIO_WRITE_PIN(DC_MOTOR_IN2_PORT_ID,DC_MOTOR_IN2_PIN_ID,LOGIC_HIGH);
+		break;
+	default:
+		/*Do Nothing*/
+		break;
+	}
+#endif
 
-	/*Send required speed to Timer0 to generate the required PWM on OC0 pin*/
-	PWM_Timer0_Start(speed);
-
+	if(state==STOP)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		PWM_Timer0_setDuty(duty);
+	}
 }
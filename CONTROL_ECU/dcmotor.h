@@ -15,16 +15,7 @@
 
 #include "std_types.h"
 #include "gpio.h"
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-#define DC_MOTOR_IN1_PORT_ID 		PORTB_ID
-#define DC_MOTOR_IN1_PIN_ID 		PIN0_ID
-#define DC_MOTOR_IN2_PORT_ID		PORTB_ID
-#define DC_MOTOR_IN2_PIN_ID			PIN1_ID
-#define DC_MOTOR_EN_PORT_ID			PORTB_ID
-#define DC_MOTOR_EN_PIN_ID			PIN3_ID
+#include "board.h" /*The motor pins are assigned in the board description*/
 
 /*******************************************************************************
  *                               Types Declaration                             *
@@ -42,9 +33,8 @@ typedef enum{
 
 /*
  * Description :
- * This function is responsible for setting up the direction of the two motor pins
- * via GPIO driver.
- * It also configure the motor to be off at the beginning via GPIO driver.
+ * This function is responsible for configuring the motor to be off at the beginning via GPIO driver.
+ * The direction of the two motor pins is set by Board_init.
  */
 void DcMotor_init(void);
 
@@ -55,7 +45,16 @@ void DcMotor_init(void);
  * It also handles the speed of the motor via sending the required speed
  * percentage to the PWM driver to output the required analog signal
  * to the motor.
+ * STOP removes the drive at once, CW and CCW ramp the speed up from standstill.
  */
 void DcMotor_Rotate(DcMotor_State state,uint8 speed);
 
+/*
+ * Description :
+ * This function sets the state of the motion and the raw duty cycle (0 --> PWM_MAX_DUTY) at once, without a ramp.
+ * The drive is removed before the control pins change, the duty is ignored in the STOP state.
+ * It's used by the layers that shape the speed themselves, like the motion profile.
+ */
+void DcMotor_drive(DcMotor_State state,uint8 duty);
+
 #endif /* DCMOTOR_H_ */
@@ -329,3 +329,80 @@ uint8 GPIO_readPort(uint8 port_num)
 
 	return value;
 }
+
+/*
+ * Description :
+ * Write the bits of the value selected by the mask on the required port, the other pins keep their values.
+ * All the pins change together in one register write, and the read-modify-write is done with the
+ * interrupts disabled so an ISR writing the same port can't be overwritten.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value)
+{
+	/* Variable to store the SREG value, to restore the I-bit after the write */
+	uint8 sreg_value;
+
+	if(port_num >= NUM_OF_PORTS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		sreg_value = SREG;
+		SREG &= ~(1<<7);
+		switch(port_num)
+		{
+		case PORTA_ID:
+			PORTA = (PORTA & ~mask) | (value & mask);
+			break;
+		case PORTB_ID:
+			PORTB = (PORTB & ~mask) | (value & mask);
+			break;
+		case PORTC_ID:
+			PORTC = (PORTC & ~mask) | (value & mask);
+			break;
+		case PORTD_ID:
+			PORTD = (PORTD & ~mask) | (value & mask);
+			break;
+		}
+		SREG = sreg_value;
+	}
+}
+
+/*
+ * Description :
+ * Setup the direction of the pins selected by the mask in one atomic register write.
+ * A set bit of the direction makes its pin an output pin, a cleared bit makes it an input pin.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_configureMasked(uint8 port_num, uint8 mask, uint8 direction)
+{
+	/* Variable to store the SREG value, to restore the I-bit after the write */
+	uint8 sreg_value;
+
+	if(port_num >= NUM_OF_PORTS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		sreg_value = SREG;
+		SREG &= ~(1<<7);
+		switch(port_num)
+		{
+		case PORTA_ID:
+			DDRA = (DDRA & ~mask) | (direction & mask);
+			break;
+		case PORTB_ID:
+			DDRB = (DDRB & ~mask) | (direction & mask);
+			break;
+		case PORTC_ID:
+			DDRC = (DDRC & ~mask) | (direction & mask);
+			break;
+		case PORTD_ID:
+			DDRD = (DDRD & ~mask) | (direction & mask);
+			break;
+		}
+		SREG = sreg_value;
+	}
+}
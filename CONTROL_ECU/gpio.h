@@ -14,6 +14,8 @@
 #define GPIO_H_
 
 #include "std_types.h"
+#include "common_macros.h" /* To use the macros like SET_BIT */
+#include <avr/io.h> /* To use the IO Ports Registers */
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -48,6 +50,79 @@ typedef enum
 	PORT_INPUT,PORT_OUTPUT=0xFF
 }GPIO_PortDirectionType;
 
+/*******************************************************************************
+ *                           Constant Pin Access                               *
+ *******************************************************************************/
+
+/*
+ * The port and pin of a pin driven by a driver are always constants from its header file, for these
+ * pins the macros below replace the functions of this driver. The register is selected at compile time
+ * and no check is done at run time, so each access is a single access of the register. With the
+ * constant arguments avr-gcc is expected to emit one sbi, cbi or sbis/sbic for it, this is not
+ * checked by the host tests.
+ * A port or pin number out of range, or one that isn't a constant, is a build error instead of an
+ * ignored request. The functions remain for the port and pin numbers only known at run time.
+ */
+
+/* Fails to compile if the port number isn't a constant or isn't correct */
+#define GPIO_CHECK_PORT(port_num) \
+	((void)sizeof(struct{ _Static_assert((port_num) < NUM_OF_PORTS, "GPIO port number out of range"); char c; }))
+
+/* Fails to compile if the port number or pin number aren't constants or aren't correct */
+#define GPIO_CHECK_PIN(port_num,pin_num) \
+	((void)sizeof(struct{ _Static_assert(((port_num) < NUM_OF_PORTS) && ((pin_num) < NUM_OF_PINS_PER_PORT), \
+	"GPIO port or pin number out of range"); char c; }))
+
+/* Register of the required port, the port number is checked like the pin macros */
+#define GPIO_PORT_REG(port_num)  (*(GPIO_CHECK_PORT(port_num), ((port_num) == PORTA_ID) ? &PORTA : \
+                                    ((port_num) == PORTB_ID) ? &PORTB : ((port_num) == PORTC_ID) ? &PORTC : &PORTD))
+#define GPIO_DDR_REG(port_num)   (*(GPIO_CHECK_PORT(port_num), ((port_num) == PORTA_ID) ? &DDRA : \
+                                    ((port_num) == PORTB_ID) ? &DDRB : ((port_num) == PORTC_ID) ? &DDRC : &DDRD))
+#define GPIO_PIN_REG(port_num)   (*(GPIO_CHECK_PORT(port_num), ((port_num) == PORTA_ID) ? &PINA : \
+                                    ((port_num) == PORTB_ID) ? &PINB : ((port_num) == PORTC_ID) ? &PINC : &PIND))
+
+/* Setup the direction of the required pin input/output, like GPIO_setupPinDirection */
+#define GPIO_SETUP_PIN_DIRECTION(port_num,pin_num,direction) \
+	do{ \
+		GPIO_CHECK_PIN(port_num,pin_num); \
+		if((direction) == PIN_OUTPUT){ SET_BIT(GPIO_DDR_REG(port_num),(pin_num)); } \
+		else{ CLEAR_BIT(GPIO_DDR_REG(port_num),(pin_num)); } \
+	}while(0)
+
+/* Write the value Logic High or Logic Low on the required pin, like GPIO_writePin */
+#define GPIO_WRITE_PIN(port_num,pin_num,value) \
+	do{ \
+		GPIO_CHECK_PIN(port_num,pin_num); \
+		if((value) == LOGIC_HIGH){ SET_BIT(GPIO_PORT_REG(port_num),(pin_num)); } \
+		else{ CLEAR_BIT(GPIO_PORT_REG(port_num),(pin_num)); } \
+	}while(0)
+
+/* Write the value bits of the mask on the required port in one atomic write, like GPIO_writeMasked */
+#define GPIO_WRITE_MASKED(port_num,mask,value) \
+	do{ \
+		uint8 gpio_sreg_value; \
+		GPIO_CHECK_PORT(port_num); \
+		gpio_sreg_value = SREG; \
+		SREG &= ~(1<<7); \
+		GPIO_PORT_REG(port_num) = (GPIO_PORT_REG(port_num) & (uint8)~(mask)) | ((value) & (mask)); \
+		SREG = gpio_sreg_value; \
+	}while(0)
+
+/* Setup the direction of the mask pins in one atomic write, like GPIO_configureMasked */
+#define GPIO_CONFIGURE_MASKED(port_num,mask,direction) \
+	do{ \
+		uint8 gpio_sreg_value; \
+		GPIO_CHECK_PORT(port_num); \
+		gpio_sreg_value = SREG; \
+		SREG &= ~(1<<7); \
+		GPIO_DDR_REG(port_num) = (GPIO_DDR_REG(port_num) & (uint8)~(mask)) | ((direction) & (mask)); \
+		SREG = gpio_sreg_value; \
+	}while(0)
+
+/* Read and return the value for the required pin, Logic High or Logic Low, like GPIO_readPin */
+#define GPIO_READ_PIN(port_num,pin_num) \
+	(GPIO_CHECK_PIN(port_num,pin_num), (BIT_IS_SET(GPIO_PIN_REG(port_num),(pin_num)) ? LOGIC_HIGH : LOGIC_LOW))
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -74,6 +149,23 @@ void GPIO_writePin(uint8 port_num, uint8 pin_num, uint8 value);
  */
 uint8 GPIO_readPin(uint8 port_num, uint8 pin_num);
 
+/*
+ * Description :
+ * Write the bits of the value selected by the mask on the required port, the other pins keep their values.
+ * All the pins change together in one register write, and the read-modify-write is done with the
+ * interrupts disabled so an ISR writing the same port can't be overwritten.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value);
+
+/*
+ * Description :
+ * Setup the direction of the pins selected by the mask in one atomic register write.
+ * A set bit of the direction makes its pin an output pin, a cleared bit makes it an input pin.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_configureMasked(uint8 port_num, uint8 mask, uint8 direction);
+
 /*
  * Description :
  * Setup the direction of the required port all pins input/output.
@@ -0,0 +1,294 @@
+ /******************************************************************************
+ *
+ * Module: Motion Profile
+ *
+ * File Name: motion.c
+ *
+ * Description: Source file for the trapezoidal motion profile of the DC motor
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "motion.h"
+#include "pwm.h" /*To update the duty cycle on every step*/
+#include <avr/io.h> /*To use the SREG register*/
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Profile of the running travel, NULL_PTR if the motor is stopped*/
+static const Motion_ProfileType *volatile g_motionProfile=NULL_PTR;
+
+/*Direction of the running travel*/
+static volatile DcMotor_State g_motionDirection=STOP;
+
+/*Time passed since the start of the running travel*/
+static uint16 g_motionElapsed;
+
+/*Flag set when the position feedback asks to end the cruise and start the deceleration*/
+static volatile boolean g_motionApproach=FALSE;
+
+/*Call back function called at the end of the travel, and its context*/
+static SysTimer_CallBackType g_motionDoneCallBack=NULL_PTR;
+static void *g_motionDoneContext=NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Linear interpolation from the start duty to the end duty, at the time t of a phase of the given length.
+ */
+static uint8 Motion_interpolate(uint8 start,uint8 end,uint16 t,uint16 length);
+
+/*
+ * Call back function of the motion system timer, it moves the profile one step.
+ */
+static void Motion_tickCallBack(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to start moving the motor in the given direction with the given profile.
+ * It returns immediately, the profile is run by a system timer call back and the done call back
+ * is called once the motor is stopped, from the timer call back or from Motion_endTravel.
+ * A running travel is replaced.
+ * The profile is used by reference, so it should stay valid until the travel ends.
+ */
+void Motion_start(DcMotor_State direction,const Motion_ProfileType *profile,SysTimer_CallBackType done_ptr,void *context)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the start*/
+	uint8 sreg_value;
+
+	/*The position feedback ISRs read the travel, so it's replaced with the interrupts disabled*/
+	sreg_value=SREG;
+	SREG&=~(1<<7);
+	SysTimer_stop(SYS_TIMER_MOTION);
+	g_motionDirection=direction;
+	g_motionElapsed=0;
+	g_motionApproach=FALSE;
+	g_motionDoneCallBack=done_ptr;
+	g_motionDoneContext=context;
+	g_motionProfile=profile;
+
+	/*The profile starts from standstill, the first step is taken one tick later*/
+	DcMotor_drive(direction,Motion_dutyAt(profile,0));
+	SysTimer_start(SYS_TIMER_MOTION,SYS_TIMER_MS_TO_TICKS(MOTION_TICK_MS),
+			SYS_TIMER_MS_TO_TICKS(MOTION_TICK_MS),Motion_tickCallBack,NULL_PTR);
+	SREG=sreg_value;
+}
+
+/*
+ * Description :
+ * Function to stop the motor at once and end the running travel, the done call back isn't called.
+ */
+void Motion_stop(void)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the stop*/
+	uint8 sreg_value;
+
+	sreg_value=SREG;
+	SREG&=~(1<<7);
+	SysTimer_stop(SYS_TIMER_MOTION);
+	g_motionProfile=NULL_PTR;
+	DcMotor_drive(STOP,0);
+	SREG=sreg_value;
+}
+
+/*
+ * Description :
+ * Function to end the running travel because its end position is reached, the motor is stopped at once
+ * and the done call back is called. It does nothing if no travel is running, so it's safe to call it
+ * again for the same end position.
+ */
+void Motion_endTravel(void)
+{
+	/*Variable to store the SREG value, to restore the I-bit after taking the travel*/
+	uint8 sreg_value;
+
+	/*Profile of the ended travel*/
+	const Motion_ProfileType *profile;
+
+	sreg_value=SREG;
+	SREG&=~(1<<7);
+	profile=g_motionProfile;
+	if(profile==NULL_PTR)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		SysTimer_stop(SYS_TIMER_MOTION);
+		g_motionProfile=NULL_PTR;
+		DcMotor_drive(STOP,0);
+	}
+	SREG=sreg_value;
+
+	if((profile==NULL_PTR) || (g_motionDoneCallBack==NULL_PTR))
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		/*The call back is free to start the next travel*/
+		g_motionDoneCallBack(g_motionDoneContext);
+	}
+}
+
+/*
+ * Description :
+ * Function to end the cruise of the running travel, the deceleration starts with the next step.
+ * It's called when the position feedback finds the end position close, a travel still accelerating
+ * finishes its acceleration first.
+ */
+void Motion_approach(void)
+{
+	g_motionApproach=TRUE;
+}
+
+/*
+ * Description :
+ * Function to return the direction of the running travel, STOP if no travel is running.
+ */
+DcMotor_State Motion_getDirection(void)
+{
+	if(g_motionProfile==NULL_PTR)
+	{
+		return STOP;
+	}
+	else
+	{
+		return g_motionDirection;
+	}
+}
+
+/*
+ * Description :
+ * Function to check whether a travel is running or not.
+ */
+boolean Motion_isRunning(void)
+{
+	return (g_motionProfile!=NULL_PTR);
+}
+
+/*
+ * Description :
+ * Function to return the duty cycle of the profile at the given time from the start of the travel.
+ * It has no side effects, the travel is driven by it and it can be checked against a model of the motor.
+ * The phases are placed backwards from the end of the travel, so a travel time shorter than the sum
+ * of the phases cuts the cruise, then the acceleration meets the deceleration at the lower duty.
+ * The deceleration and the approach should fit in the travel time.
+ */
+uint8 Motion_dutyAt(const Motion_ProfileType *profile,uint16 elapsed_ms)
+{
+	/*Start times of the approach and the deceleration phases*/
+	uint16 approach_start;
+	uint16 decel_start;
+
+	/*Duty of the deceleration phase, and of the acceleration phase when the two overlap*/
+	uint8 duty;
+	uint8 accel_duty;
+
+	if(elapsed_ms>=profile->travel_time_ms)
+	{
+		/*The approach goes on during the overrun time, waiting for the end position*/
+		if(elapsed_ms<(profile->travel_time_ms+profile->overrun_time_ms))
+		{
+			return profile->approach_duty;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+
+	approach_start=profile->travel_time_ms-profile->approach_time_ms;
+	decel_start=approach_start-profile->decel_time_ms;
+
+	if(elapsed_ms>=approach_start)
+	{
+		return profile->approach_duty;
+	}
+	else if(elapsed_ms>=decel_start)
+	{
+		duty=Motion_interpolate(profile->cruise_duty,profile->approach_duty,elapsed_ms-decel_start,profile->decel_time_ms);
+
+		/*Without a cruise the profile is a triangle, the lower of the two ramps is followed*/
+		if(elapsed_ms<profile->accel_time_ms)
+		{
+			accel_duty=Motion_interpolate(0,profile->cruise_duty,elapsed_ms,profile->accel_time_ms);
+			if(accel_duty<duty)
+			{
+				duty=accel_duty;
+			}
+		}
+		return duty;
+	}
+	else if(elapsed_ms<profile->accel_time_ms)
+	{
+		return Motion_interpolate(0,profile->cruise_duty,elapsed_ms,profile->accel_time_ms);
+	}
+	else
+	{
+		return profile->cruise_duty;
+	}
+}
+
+/*
+ * Description :
+ * Linear interpolation from the start duty to the end duty, at the time t of a phase of the given length.
+ * It's done in integers, the product fits in 32 bits for any phase length.
+ */
+static uint8 Motion_interpolate(uint8 start,uint8 end,uint16 t,uint16 length)
+{
+	return (uint8)((sint16)start+(sint16)((((sint32)end-(sint32)start)*(sint32)t)/(sint32)length));
+}
+
+/*
+ * Description :
+ * Call back function of the motion system timer, it moves the profile one step.
+ * At the end of the travel and its overrun time the motor is stopped and the done call back is called.
+ */
+static void Motion_tickCallBack(void *context)
+{
+	const Motion_ProfileType *profile=g_motionProfile;
+
+	/*Start time of the deceleration phase*/
+	uint16 decel_start;
+
+	if(profile==NULL_PTR)
+	{
+		SysTimer_stop(SYS_TIMER_MOTION);
+		return;
+	}
+
+	g_motionElapsed+=MOTION_TICK_MS;
+
+	/*An approach request skips the rest of the cruise*/
+	decel_start=profile->travel_time_ms-profile->approach_time_ms-profile->decel_time_ms;
+	if((g_motionApproach==FALSE) || (g_motionElapsed<profile->accel_time_ms))
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		if(g_motionElapsed<decel_start)
+		{
+			g_motionElapsed=decel_start;
+		}
+		g_motionApproach=FALSE;
+	}
+
+	if(g_motionElapsed>=(profile->travel_time_ms+profile->overrun_time_ms))
+	{
+		Motion_endTravel();
+	}
+	else
+	{
+		PWM_Timer0_setDuty(Motion_dutyAt(profile,g_motionElapsed));
+	}
+}
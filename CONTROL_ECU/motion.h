@@ -0,0 +1,106 @@
+ /******************************************************************************
+ *
+ * Module: Motion Profile
+ *
+ * File Name: motion.h
+ *
+ * Description: Header file for the trapezoidal motion profile of the DC motor
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef MOTION_H_
+#define MOTION_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+#include "dcmotor.h"
+#include "sys_timer.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Period of the profile steps, the duty cycle is updated once every tick*/
+#define MOTION_TICK_MS				10
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*
+ * A travel is split in five phases, all the times are in milliseconds:
+ * 1- Acceleration from standstill to the cruise duty in accel_time_ms.
+ * 2- Cruise at the cruise duty for the rest of the travel time.
+ * 3- Deceleration from the cruise duty to the approach duty in decel_time_ms.
+ * 4- Approach to the end stop at the approach duty for approach_time_ms.
+ * 5- Stop at the end of travel_time_ms, or go on at the approach duty for overrun_time_ms more
+ *    while waiting for the position feedback to end the travel.
+ * The duties are raw values (0 --> PWM_MAX_DUTY), decel_time_ms+approach_time_ms should fit in travel_time_ms.
+ */
+typedef struct{
+	uint16 travel_time_ms;
+	uint16 accel_time_ms;
+	uint16 decel_time_ms;
+	uint16 approach_time_ms;
+	uint16 overrun_time_ms;
+	uint8 cruise_duty;
+	uint8 approach_duty;
+}Motion_ProfileType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to start moving the motor in the given direction with the given profile.
+ * It returns immediately, the profile is run by a system timer call back and the done call back
+ * is called once the motor is stopped, from the timer call back or from Motion_endTravel.
+ * A running travel is replaced.
+ * The profile is used by reference, so it should stay valid until the travel ends.
+ */
+void Motion_start(DcMotor_State direction,const Motion_ProfileType *profile,SysTimer_CallBackType done_ptr,void *context);
+
+/*
+ * Description :
+ * Function to stop the motor at once and end the running travel, the done call back isn't called.
+ */
+void Motion_stop(void);
+
+/*
+ * Description :
+ * Function to end the running travel because its end position is reached, the motor is stopped at once
+ * and the done call back is called. It does nothing if no travel is running, so it's safe to call it
+ * again for the same end position.
+ */
+void Motion_endTravel(void);
+
+/*
+ * Description :
+ * Function to end the cruise of the running travel, the deceleration starts with the next step.
+ * It's called when the position feedback finds the end position close, a travel still accelerating
+ * finishes its acceleration first.
+ */
+void Motion_approach(void);
+
+/*
+ * Description :
+ * Function to return the direction of the running travel, STOP if no travel is running.
+ */
+DcMotor_State Motion_getDirection(void);
+
+/*
+ * Description :
+ * Function to check whether a travel is running or not.
+ */
+boolean Motion_isRunning(void);
+
+/*
+ * Description :
+ * Function to return the duty cycle of the profile at the given time from the start of the travel.
+ * It has no side effects, the travel is driven by it and it can be checked against a model of the motor.
+ */
+uint8 Motion_dutyAt(const Motion_ProfileType *profile,uint16 elapsed_ms);
+
+#endif /* MOTION_H_ */
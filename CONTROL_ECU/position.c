@@ -0,0 +1,201 @@
+ /******************************************************************************
+ *
+ * Module: Door Position
+ *
+ * File Name: position.c
+ *
+ * Description: Source file for the door position feedback, the end stop switches and the optional encoder
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "position.h"
+#include "motion.h" /*To end the running travel*/
+#include "exti.h" /*The switches and the encoder are on the external interrupt lines*/
+#include <avr/io.h> /*To use the SREG register*/
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Encoder count of the door position, written by the INT1 and INT2 ISRs*/
+static volatile sint16 g_positionCount=0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * End the running travel if it moves in the given direction.
+ */
+static void Position_endStop(DcMotor_State direction);
+
+/*
+ * Call back functions of the open and closed end stop switches, they run inside the ISRs.
+ */
+static void Position_openLimitCallBack(void *context);
+static void Position_closedLimitCallBack(void *context);
+
+#if (DOOR_ENCODER_CONNECTED == TRUE)
+/*
+ * Call back function of the encoder channel A, it runs inside the INT2 ISR.
+ */
+static void Position_encoderCallBack(void *context);
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to attach the end stop switches to INT0 and INT1, and the encoder to INT2 if it's fitted.
+ * It should be called after SysTimer_init, the switches end the running motion travel from their ISRs.
+ * The pins directions and pull-ups are set by Board_init.
+ */
+void Position_init(void)
+{
+	/*A switch closing to ground gives a falling edge, its bounces are ignored by Motion_endTravel*/
+	Exti_init(EXTI_INT0,EXTI_FALLING_EDGE,EXTI_DISPATCH_ISR,Position_openLimitCallBack,NULL_PTR);
+	Exti_init(EXTI_INT1,EXTI_FALLING_EDGE,EXTI_DISPATCH_ISR,Position_closedLimitCallBack,NULL_PTR);
+	Exti_enable(EXTI_INT0);
+	Exti_enable(EXTI_INT1);
+
+#if (DOOR_ENCODER_CONNECTED == TRUE)
+	Exti_init(EXTI_INT2,EXTI_FALLING_EDGE,EXTI_DISPATCH_ISR,Position_encoderCallBack,NULL_PTR);
+	Exti_enable(EXTI_INT2);
+#endif
+}
+
+/*
+ * Description :
+ * Function to check whether the end stop switch of the given travel direction is closed.
+ */
+boolean Position_isReached(DcMotor_State direction)
+{
+	if(direction==POSITION_OPEN_DIRECTION)
+	{
+		return (GPIO_READ_PIN(DOOR_OPEN_LIMIT_PORT_ID,DOOR_OPEN_LIMIT_PIN_ID)==POSITION_SWITCH_ACTIVE);
+	}
+	else if(direction==POSITION_CLOSE_DIRECTION)
+	{
+		return (GPIO_READ_PIN(DOOR_CLOSED_LIMIT_PORT_ID,DOOR_CLOSED_LIMIT_PIN_ID)==POSITION_SWITCH_ACTIVE);
+	}
+	else
+	{
+		return FALSE;
+	}
+}
+
+/*
+ * Description :
+ * Function to end the running travel if its end stop switch is already closed, so a travel that starts
+ * at its end doesn't wait for an edge that never comes. It should be called after Motion_start, from the
+ * main context: ending the travel runs the done call back, which shouldn't run again inside the call back
+ * that started the travel.
+ */
+void Position_checkReached(void)
+{
+	DcMotor_State direction=Motion_getDirection();
+
+	if(Position_isReached(direction))
+	{
+		/*An edge taken between the two calls already ended the travel, then this call does nothing*/
+		Motion_endTravel();
+	}
+	else
+	{
+		/*Do Nothing*/
+	}
+}
+
+/*
+ * Description :
+ * Function to return the encoder count, 0 at the closed end and POSITION_OPEN_COUNT at the open end.
+ * It's always 0 if the encoder isn't fitted.
+ */
+sint16 Position_getCount(void)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the read*/
+	uint8 sreg_value;
+
+	/*The count is two bytes written by the ISRs, it's read with the interrupts disabled*/
+	sint16 count;
+
+	sreg_value=SREG;
+	SREG&=~(1<<7);
+	count=g_positionCount;
+	SREG=sreg_value;
+
+	return count;
+}
+
+/*
+ * Description :
+ * End the running travel if it moves in the given direction.
+ * The switch left at the start of the next travel bounces too, but that travel moves the other way.
+ */
+static void Position_endStop(DcMotor_State direction)
+{
+	if(Motion_getDirection()==direction)
+	{
+		Motion_endTravel();
+	}
+	else
+	{
+		/*Do Nothing*/
+	}
+}
+
+/*
+ * Description :
+ * Call back function of the open end stop switch, it runs inside the INT0 ISR.
+ */
+static void Position_openLimitCallBack(void *context)
+{
+	Position_endStop(POSITION_OPEN_DIRECTION);
+}
+
+/*
+ * Description :
+ * Call back function of the closed end stop switch, it runs inside the INT1 ISR.
+ * The closed end is the encoder origin, the count is reset on it to remove any drift.
+ */
+static void Position_closedLimitCallBack(void *context)
+{
+	g_positionCount=0;
+	Position_endStop(POSITION_CLOSE_DIRECTION);
+}
+
+#if (DOOR_ENCODER_CONNECTED == TRUE)
+/*
+ * Description :
+ * Call back function of the encoder channel A, it runs inside the INT2 ISR.
+ * On a falling edge of channel A the level of channel B gives the direction, one count per encoder cycle.
+ * The running travel starts its deceleration when it gets within POSITION_APPROACH_COUNT of its end.
+ */
+static void Position_encoderCallBack(void *context)
+{
+	DcMotor_State direction;
+
+	if(GPIO_READ_PIN(DOOR_ENCODER_B_PORT_ID,DOOR_ENCODER_B_PIN_ID)==LOGIC_HIGH)
+	{
+		g_positionCount++;
+	}
+	else
+	{
+		g_positionCount--;
+	}
+
+	direction=Motion_getDirection();
+	if(((direction==POSITION_OPEN_DIRECTION) && (g_positionCount>=(POSITION_OPEN_COUNT-POSITION_APPROACH_COUNT))) ||
+	   ((direction==POSITION_CLOSE_DIRECTION) && (g_positionCount<=POSITION_APPROACH_COUNT)))
+	{
+		Motion_approach();
+	}
+	else
+	{
+		/*Do Nothing*/
+	}
+}
+#endif
@@ -0,0 +1,72 @@
+ /******************************************************************************
+ *
+ * Module: Door Position
+ *
+ * File Name: position.h
+ *
+ * Description: Header file for the door position feedback, the end stop switches and the optional encoder
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef POSITION_H_
+#define POSITION_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+#include "board.h" /*The switches and encoder pins are assigned in the board description*/
+#include "dcmotor.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Motor direction of each travel of the door*/
+#define POSITION_OPEN_DIRECTION		CW
+#define POSITION_CLOSE_DIRECTION	CCW
+
+/*Level of an end stop switch when the door is at its end*/
+#define POSITION_SWITCH_ACTIVE		LOGIC_LOW
+
+/*
+ * Encoder counts of the full travel from closed to open, the count is set to 0 on the closed switch.
+ * The travel starts its deceleration when it's within the approach counts of its end.
+ */
+#define POSITION_OPEN_COUNT			1200
+#define POSITION_APPROACH_COUNT		150
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to attach the end stop switches to INT0 and INT1, and the encoder to INT2 if it's fitted.
+ * It should be called after SysTimer_init, the switches end the running motion travel from their ISRs.
+ */
+void Position_init(void);
+
+/*
+ * Description :
+ * Function to check whether the end stop switch of the given travel direction is closed.
+ */
+boolean Position_isReached(DcMotor_State direction);
+
+/*
+ * Description :
+ * Function to end the running travel if its end stop switch is already closed, so a travel that starts
+ * at its end doesn't wait for an edge that never comes. It should be called after Motion_start, from the
+ * main context: ending the travel runs the done call back, which shouldn't run again inside the call back
+ * that started the travel.
+ */
+void Position_checkReached(void);
+
+/*
+ * Description :
+ * Function to return the encoder count, 0 at the closed end and POSITION_OPEN_COUNT at the open end.
+ * It's always 0 if the encoder isn't fitted.
+ */
+sint16 Position_getCount(void);
+
+#endif /* POSITION_H_ */
@@ -10,67 +10,204 @@
  *
  *******************************************************************************/
 #include "pwm.h"
-#include "gpio.h"/*To set pin directions*/
+#include "timer_mgr.h"/*To check the ownership of Timer0*/
+#include "sys_timer.h"/*To step the ramps*/
 #include <avr/io.h> /*To use Timer0 registers*/
+#include <avr/pgmspace.h> /*To keep the percentage table in the flash*/
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Clock select bits CS02:CS00 of the selected prescaler*/
+#if (PWM_PRESCALER == 1UL)
+#define PWM_CLOCK_SELECT			(1<<CS00)
+#elif (PWM_PRESCALER == 8UL)
+#define PWM_CLOCK_SELECT			(1<<CS01)
+#elif (PWM_PRESCALER == 64UL)
+#define PWM_CLOCK_SELECT			((1<<CS01)|(1<<CS00))
+#elif (PWM_PRESCALER == 256UL)
+#define PWM_CLOCK_SELECT			(1<<CS02)
+#else
+#define PWM_CLOCK_SELECT			((1<<CS02)|(1<<CS00))
+#endif
+
+/*Waveform generation bits of the selected mode, WGM01 selects the fast mode*/
+#if (PWM_MODE == PWM_MODE_FAST)
+#define PWM_WAVEFORM_MODE			((1<<WGM00)|(1<<WGM01))
+#else
+#define PWM_WAVEFORM_MODE			(1<<WGM00)
+#endif
+
+/*******************************************************************************
+ *                      Preprocessor Error                                     *
+ *******************************************************************************/
+#if (TIMER0_OWNER != TIMER_OWNER_PWM)
+#error "Timer0 isn't assigned to the PWM driver in timer_mgr.h"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*
+ * Duty value of each percentage, (percent*256)/100 limited to PWM_MAX_DUTY.
+ * It replaces the float calculation, so the float library isn't linked for the PWM.
+ */
+static const uint8 g_pwmPercentToDuty[101] PROGMEM = {
+	  0,   2,   5,   7,  10,  12,  15,  17,  20,  23,
+	 25,  28,  30,  33,  35,  38,  40,  43,  46,  48,
+	 51,  53,  56,  58,  61,  64,  66,  69,  71,  74,
+	 76,  79,  81,  84,  87,  89,  92,  94,  97,  99,
+	102, 104, 107, 110, 112, 115, 117, 120, 122, 125,
+	128, 130, 133, 135, 138, 140, 143, 145, 148, 151,
+	153, 156, 158, 161, 163, 166, 168, 171, 174, 176,
+	179, 181, 184, 186, 189, 192, 194, 197, 199, 202,
+	204, 207, 209, 212, 215, 217, 220, 222, 225, 227,
+	230, 232, 235, 238, 240, 243, 245, 248, 250, 253,
+	255
+};
+
+/*Duty cycle of the running ramp in 8.8 fixed point, and its step per tick*/
+static uint16 g_pwmRampDuty;
+static sint16 g_pwmRampStep;
+
+/*Target duty of the running ramp and the number of steps left to reach it*/
+static uint8 g_pwmRampTarget;
+static uint16 g_pwmRampSteps;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Write the duty value to OCR0 and start Timer0 in the selected PWM mode if it isn't running.
+ */
+static void PWM_Timer0_output(uint8 duty);
+
+/*
+ * Call back function of the ramp system timer, it moves the duty cycle one step.
+ */
+static void PWM_rampCallBack(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
 /*
  * Description :
  * This Function is responsible for:
- * 1- Setting up Timer0 with PWM mode.
+ * 1- Setting up Timer0 with the selected PWM mode.
  * 2- setting PWM with non-inverting mode.
- * 3- Timer prescaler.
+ * 3- Timer prescaler, selected at compile time for PWM_FREQUENCY_HZ.
  * 4- Initializing the compare value based on the input duty cycle.
- * 5- Configure the direction of the OC0 pin.
- * 6- Setting the PWM frequency to be 500 HZ to be compatible with motor
- *    operational frequency.
- * Function inputs: Required duty cycle.
+ * Function inputs: Required duty cycle in percent (0 --> 100).
+ * A running ramp is stopped.
  */
 void PWM_Timer0_Start(uint8 duty_cycle)
 {
-	/*Variable to store the required OCR0 register value*/
-	uint16 req_OCR0_value=0;
+	PWM_Timer0_setDuty(PWM_percentToDuty(duty_cycle));
+}
 
-	/*Flag to set TCNT0 register only once.
-	 * It's static to initialize it with the first call of the function only, then keep
-	 * its value with further call of this function.
-	 */
-	static uint8 TCNT0_flag= 1;
+/*
+ * Description :
+ * Function to set the duty cycle directly, from 0 to PWM_MAX_DUTY, Timer0 is started if it isn't running.
+ * A running ramp is stopped.
+ */
+void PWM_Timer0_setDuty(uint8 duty)
+{
+	SysTimer_stop(SYS_TIMER_PWM_RAMP);
+	PWM_Timer0_output(duty);
+}
 
-	/*Set OC0 as output pin*/
-	GPIO_setupPinDirection(PORTB_ID,PIN3_ID,PIN_OUTPUT);
+/*
+ * Description :
+ * Function to move the duty cycle linearly from its current value to the target duty (0 --> PWM_MAX_DUTY)
+ * over the given time, one step every PWM_RAMP_TICK_MS. A time shorter than two ticks sets the target at once.
+ * It returns immediately, the steps are done by a system timer call back.
+ */
+void PWM_Timer0_ramp(uint8 target_duty,uint16 time_ms)
+{
+	uint16 steps=time_ms/PWM_RAMP_TICK_MS;
 
-	/*Initialize TCNT0*/
-	if(TCNT0_flag== 1)
+	SysTimer_stop(SYS_TIMER_PWM_RAMP);
+	if(steps<=1)
 	{
-		TCNT0_flag= 0;
-		TCNT0=0;
+		/*A single step is the target itself, and its 8.8 step wouldn't fit in 16 bits*/
+		PWM_Timer0_output(target_duty);
 	}
-
-	/*Calculating the equivalent OCR register value base on the input duty cycle
-	  percentage*/
-	req_OCR0_value=(uint16)(((float32)duty_cycle/100.0)*256);
-
-	/*Check for overflow, i.e, 100% duty cycle*/
-	if(req_OCR0_value==256)
+	else
 	{
-		/*Decrement the value by one, in case of overflow, to be able
-		 * to store this value in OCR0, which is an 8-bit register.
-		 */
-		req_OCR0_value--;
+		/*The ramp starts from the duty in OCR0, so a ramp replacing another one doesn't jump*/
+		g_pwmRampDuty=(uint16)OCR0<<8;
+		g_pwmRampStep=(sint16)((((sint32)target_duty-(sint32)OCR0)*256)/(sint32)steps);
+		g_pwmRampTarget=target_duty;
+		g_pwmRampSteps=steps;
+		PWM_Timer0_output(OCR0);
+		SysTimer_start(SYS_TIMER_PWM_RAMP,SYS_TIMER_MS_TO_TICKS(PWM_RAMP_TICK_MS),
+				SYS_TIMER_MS_TO_TICKS(PWM_RAMP_TICK_MS),PWM_rampCallBack,NULL_PTR);
 	}
+}
 
-	/*assign the required OCR0 value*/
-	OCR0=(uint8)req_OCR0_value;
-
+/*
+ * Description :
+ * Function to convert a duty cycle percentage (0 --> 100) to a duty value (0 --> PWM_MAX_DUTY).
+ * Percentages above 100 are limited to 100.
+ */
+uint8 PWM_percentToDuty(uint8 percent)
+{
+	if(percent>100)
+	{
+		percent=100;
+	}
+	return pgm_read_byte(&g_pwmPercentToDuty[percent]);
+}
 
+/*
+ * Description :
+ * Write the duty value to OCR0 and start Timer0 in the selected PWM mode if it isn't running.
+ * OCR0 is double buffered in both PWM modes, the new duty starts with the next PWM period.
+ */
+static void PWM_Timer0_output(uint8 duty)
+{
+	/*The OC0 compare unit drives the motor, don't touch it if another service holds it*/
+	if(!TimerMgr_claimChannel(TIMER0_COMP_CHANNEL,TIMER_USER_PWM))
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		/*assign the required OCR0 value*/
+		OCR0=duty;
 
-	/*Configure The control bits in TCCR0 register to work with PWM mode.
-	 * FOC0=0 -> PWM-mode
-	 * WGM00=WGM01=1 -> Fast PWM
-	 * COM01=1 / COM00=0 -> non=inverting mode
-	 * CS01=1 / CS00=0 / CS02=0 -> prescaler F_CPU/8
-	 */
-	TCCR0=(1<<WGM00)|(1<<WGM01)|(1<<CS01)|(1<<COM01);
+		if(TCCR0==0)
+		{
+			/*Initialize TCNT0 once, when the timer starts*/
+			TCNT0=0;
 
+			/*Configure The control bits in TCCR0 register to work with PWM mode.
+			 * FOC0=0 -> PWM-mode
+			 * WGM00=1 / WGM01=1 -> Fast PWM, WGM01=0 -> Phase Correct PWM
+			 * COM01=1 / COM00=0 -> non=inverting mode
+			 * CS02:CS00 -> prescaler of PWM_FREQUENCY_HZ
+			 */
+			TCCR0=PWM_WAVEFORM_MODE|PWM_CLOCK_SELECT|(1<<COM01);
+		}
+	}
 }
 
-
+/*
+ * Description :
+ * Call back function of the ramp system timer, it moves the duty cycle one step.
+ * The last step writes the target itself, so the rounding of the step never leaves the ramp short.
+ */
+static void PWM_rampCallBack(void *context)
+{
+	g_pwmRampSteps--;
+	if(g_pwmRampSteps==0)
+	{
+		SysTimer_stop(SYS_TIMER_PWM_RAMP);
+		OCR0=g_pwmRampTarget;
+	}
+	else
+	{
+		g_pwmRampDuty+=(uint16)g_pwmRampStep;
+		OCR0=(uint8)(g_pwmRampDuty>>8);
+	}
+}
@@ -15,6 +15,76 @@
 
 #include "std_types.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* CPU Clock Frequency, used to compute the PWM frequency */
+#define PWM_F_CPU                     8000000UL
+
+/* PWM modes of Timer0 */
+#define PWM_MODE_FAST                 0
+#define PWM_MODE_PHASE_CORRECT        1
+
+/*
+ * Selected PWM mode and carrier frequency in Hz, Timer0 generates the closest frequency its prescalers allow.
+ * The fast mode doubles the frequency for the same prescaler, the phase correct mode gives symmetric pulses.
+ */
+#define PWM_MODE                      PWM_MODE_FAST
+#define PWM_FREQUENCY_HZ              3900UL
+
+/* Largest accepted error of the generated frequency, in percent of the selected one */
+#define PWM_FREQUENCY_TOLERANCE       25
+
+/* Timer0 counts in one PWM period, its TOP is fixed at 0xFF so the phase correct mode counts up then down */
+#if (PWM_MODE == PWM_MODE_FAST)
+#define PWM_PERIOD_COUNTS             256UL
+#elif (PWM_MODE == PWM_MODE_PHASE_CORRECT)
+#define PWM_PERIOD_COUNTS             510UL
+#else
+#error "The selected PWM mode isn't supported"
+#endif
+
+/* PWM frequency generated with a prescaler, and its error from the selected frequency */
+#define PWM_FREQUENCY_AT(prescaler)   (PWM_F_CPU/((prescaler)*PWM_PERIOD_COUNTS))
+#define PWM_FREQUENCY_ERROR(prescaler) \
+	((PWM_FREQUENCY_AT(prescaler) > PWM_FREQUENCY_HZ) ? \
+	 (PWM_FREQUENCY_AT(prescaler)-PWM_FREQUENCY_HZ) : (PWM_FREQUENCY_HZ-PWM_FREQUENCY_AT(prescaler)))
+
+/* Timer0 prescaler giving the closest frequency, the frequency falls as the prescaler grows */
+#if (PWM_FREQUENCY_ERROR(1UL) <= PWM_FREQUENCY_ERROR(8UL))
+#define PWM_PRESCALER                 1UL
+#elif (PWM_FREQUENCY_ERROR(8UL) <= PWM_FREQUENCY_ERROR(64UL))
+#define PWM_PRESCALER                 8UL
+#elif (PWM_FREQUENCY_ERROR(64UL) <= PWM_FREQUENCY_ERROR(256UL))
+#define PWM_PRESCALER                 64UL
+#elif (PWM_FREQUENCY_ERROR(256UL) <= PWM_FREQUENCY_ERROR(1024UL))
+#define PWM_PRESCALER                 256UL
+#else
+#define PWM_PRESCALER                 1024UL
+#endif
+
+/*
+ * Achieved carrier frequency in Hz and duty cycle resolution.
+ * The resolution is 8 bits in both modes as TOP is fixed, OCR0=0 is a full 0% only in the phase correct
+ * mode, the fast mode still outputs a one count spike every period.
+ */
+#define PWM_ACTUAL_FREQUENCY_HZ       PWM_FREQUENCY_AT(PWM_PRESCALER)
+#define PWM_RESOLUTION_BITS           8
+
+/* Maximum duty cycle value, it's written to OCR0 as is */
+#define PWM_MAX_DUTY                  255
+
+/* Period of the ramp steps, a ramp moves the duty cycle once every tick */
+#define PWM_RAMP_TICK_MS              10
+
+/*******************************************************************************
+ *                      Preprocessor Error                                     *
+ *******************************************************************************/
+#if ((PWM_FREQUENCY_ERROR(PWM_PRESCALER)*100UL) > (PWM_FREQUENCY_HZ*PWM_FREQUENCY_TOLERANCE))
+#error "Timer0 can't generate the selected PWM frequency within the tolerance, change the frequency or the mode"
+#endif
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -22,15 +92,35 @@
 /*
  * Description :
  * This Function is responsible for:
- * 1- Setting up Timer0 with PWM mode.
+ * 1- Setting up Timer0 with the selected PWM mode.
  * 2- setting PWM with non-inverting mode.
- * 3- Timer prescaler.
+ * 3- Timer prescaler, selected at compile time for PWM_FREQUENCY_HZ.
  * 4- Initializing the compare value based on the input duty cycle.
- * 5- Configure the direction of the OC0 pin.
- * 6- Setting the PWM frequency to be 500 HZ to be compatible with motor
- *    operational frquency.
- * Function inputs: Required duty cycle.
+ * Function inputs: Required duty cycle in percent (0 --> 100).
+ * A running ramp is stopped.
  */
 void PWM_Timer0_Start(uint8 duty_cycle);
 
+/*
+ * Description :
+ * Function to set the duty cycle directly, from 0 to PWM_MAX_DUTY, Timer0 is started if it isn't running.
+ * A running ramp is stopped.
+ */
+void PWM_Timer0_setDuty(uint8 duty);
+
+/*
+ * Description :
+ * Function to move the duty cycle linearly from its current value to the target duty (0 --> PWM_MAX_DUTY)
+ * over the given time, one step every PWM_RAMP_TICK_MS. A time shorter than two ticks sets the target at once.
+ * It returns immediately, the steps are done by a system timer call back.
+ */
+void PWM_Timer0_ramp(uint8 target_duty,uint16 time_ms);
+
+/*
+ * Description :
+ * Function to convert a duty cycle percentage (0 --> 100) to a duty value (0 --> PWM_MAX_DUTY).
+ * Percentages above 100 are limited to 100.
+ */
+uint8 PWM_percentToDuty(uint8 percent);
+
 #endif /* PWM_H_ */
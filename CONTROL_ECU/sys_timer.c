@@ -0,0 +1,272 @@
+/******************************************************************************
+ *
+ * Module: System Timer
+ *
+ * File Name: sys_timer.c
+ *
+ * Description: Source file for the tickless software timers service
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "sys_timer.h"
+#include "timer1.h"
+#include <avr/io.h> /*To use the SREG register*/
+#include <avr/interrupt.h> /*To use sei before sleeping*/
+#include <avr/sleep.h>
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef struct{
+	uint32 deadline;
+	uint32 period;
+	SysTimer_CallBackType callBack;
+	void *context;
+	boolean active;
+}SysTimer_Entry;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Table of the software timers, the deadlines are absolute timestamps*/
+static SysTimer_Entry g_sysTimers[SYS_TIMER_NUM_OF_TIMERS];
+
+/*Flag set while the expired timers are dispatched, the compare channel is programmed once at the end*/
+static boolean g_dispatching=FALSE;
+
+/*Flag set whenever a call back runs, it prevents SysTimer_idle from sleeping over a new event*/
+static volatile boolean g_timerEvent=FALSE;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Program the Timer1 channel A for the earliest pending deadline, or stop it if no timer is running.
+ */
+static void SysTimer_program(void);
+
+/*
+ * Call back function of the Timer1 channel A, it runs the expired timers then programs the next deadline.
+ */
+static void SysTimer_compareCallBack(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to attach the service to the Timer1 channel A.
+ * It should be called after Timestamp_init, as the deadlines are kept in timestamp ticks.
+ */
+void SysTimer_init(void)
+{
+	uint8 id;
+
+	for(id=0;id<SYS_TIMER_NUM_OF_TIMERS;id++)
+	{
+		g_sysTimers[id].active=FALSE;
+	}
+	Timer1_setEventCallBack(TIMER1_COMPA_EVENT,SysTimer_compareCallBack,NULL_PTR);
+}
+
+/*
+ * Description :
+ * Function to start a software timer that expires after the given delay in ticks.
+ * If the period isn't zero the timer is re-armed by the period on every expiry, otherwise it's a one shot.
+ * Starting a running timer replaces its deadline, it's safe to call from a call back.
+ */
+void SysTimer_start(SysTimer_Id id,uint32 delay,uint32 period,SysTimer_CallBackType a_ptr,void *context)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value;
+
+	if((id>=SYS_TIMER_NUM_OF_TIMERS) || (a_ptr==NULL_PTR))
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+		g_sysTimers[id].deadline=Timestamp_now()+delay;
+		g_sysTimers[id].period=period;
+		g_sysTimers[id].callBack=a_ptr;
+		g_sysTimers[id].context=context;
+		g_sysTimers[id].active=TRUE;
+		if(g_dispatching==FALSE)
+		{
+			SysTimer_program();
+		}
+		SREG=sreg_value;
+	}
+}
+
+/*
+ * Description :
+ * Function to stop a software timer, it's safe to call from a call back.
+ */
+void SysTimer_stop(SysTimer_Id id)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value;
+
+	if(id>=SYS_TIMER_NUM_OF_TIMERS)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+		g_sysTimers[id].active=FALSE;
+		if(g_dispatching==FALSE)
+		{
+			SysTimer_program();
+		}
+		SREG=sreg_value;
+	}
+}
+
+/*
+ * Description :
+ * Function to put the CPU in the idle sleep mode until the next interrupt.
+ * It returns immediately if a timer call back ran since the previous call, so a flag
+ * checked by the caller before sleeping can't be missed. It should be called with the I-bit set.
+ */
+void SysTimer_idle(void)
+{
+	SREG&=~(1<<7);
+	if(g_timerEvent==FALSE)
+	{
+		/*The idle mode keeps Timer1 and the UART clocked, so any of their interrupts wakes the CPU*/
+		set_sleep_mode(SLEEP_MODE_IDLE);
+		sleep_enable();
+
+		/*The instruction after sei is always executed before a pending interrupt, so no wake up is lost*/
+		sei();
+		sleep_cpu();
+		sleep_disable();
+		SREG&=~(1<<7);
+	}
+	g_timerEvent=FALSE;
+	SREG|=(1<<7);
+}
+
+/*
+ * Description :
+ * Function to make the next SysTimer_idle call return without sleeping.
+ * It's called by the ISRs that post work to the main context outside of a timer call back.
+ */
+void SysTimer_notify(void)
+{
+	g_timerEvent=TRUE;
+}
+
+/*
+ * Description :
+ * Program the Timer1 channel A for the earliest pending deadline, or stop it if no timer is running.
+ * A deadline further than one counter period is approached by a compare match every SYS_TIMER_MAX_DELTA
+ * ticks, so no interrupt is taken at all while the system is idle except the time base overflow.
+ * It's called with the I-bit cleared.
+ */
+static void SysTimer_program(void)
+{
+	uint8 id;
+	uint32 now=Timestamp_now();
+	sint32 remaining;
+	sint32 nearest=0;
+	boolean found=FALSE;
+
+	for(id=0;id<SYS_TIMER_NUM_OF_TIMERS;id++)
+	{
+		if(g_sysTimers[id].active==FALSE)
+		{
+			/*Do Nothing*/
+		}
+		else
+		{
+			/*The signed difference stays correct when the 32-bit timestamp wraps around*/
+			remaining=(sint32)(g_sysTimers[id].deadline-now);
+			if((found==FALSE) || (remaining<nearest))
+			{
+				nearest=remaining;
+				found=TRUE;
+			}
+		}
+	}
+
+	if(found==FALSE)
+	{
+		Timer1_stopChannel(TIMER1_CHANNEL_A);
+	}
+	else
+	{
+		if(nearest<SYS_TIMER_MIN_DELTA)
+		{
+			nearest=SYS_TIMER_MIN_DELTA;
+		}
+		else if(nearest>(SYS_TIMER_MAX_DELTA+SYS_TIMER_MIN_DELTA))
+		{
+			nearest=SYS_TIMER_MAX_DELTA;
+		}
+		else if(nearest>SYS_TIMER_MAX_DELTA)
+		{
+			/*Leave at least the minimum distance for the last hop, or the deadline would be delayed to it*/
+			nearest-=SYS_TIMER_MIN_DELTA;
+		}
+		Timer1_startChannel(TIMER1_CHANNEL_A,(uint16)nearest);
+	}
+}
+
+/*
+ * Description :
+ * Call back function of the Timer1 channel A, it runs the expired timers then programs the next deadline.
+ * The table is scanned again after any expiry, as a call back may start a timer that's already due.
+ */
+static void SysTimer_compareCallBack(void *context)
+{
+	uint8 id;
+	uint32 now;
+	boolean expired;
+
+	g_dispatching=TRUE;
+	do
+	{
+		expired=FALSE;
+		now=Timestamp_now();
+		for(id=0;id<SYS_TIMER_NUM_OF_TIMERS;id++)
+		{
+			if((g_sysTimers[id].active==FALSE) || ((sint32)(g_sysTimers[id].deadline-now)>0))
+			{
+				/*Do Nothing*/
+			}
+			else
+			{
+				if(g_sysTimers[id].period==0)
+				{
+					g_sysTimers[id].active=FALSE;
+				}
+				else
+				{
+					/*Keep the period phase, but skip the missed periods instead of running them back to back*/
+					g_sysTimers[id].deadline+=g_sysTimers[id].period;
+					if((sint32)(g_sysTimers[id].deadline-now)<=0)
+					{
+						g_sysTimers[id].deadline=now+g_sysTimers[id].period;
+					}
+				}
+				(*g_sysTimers[id].callBack)(g_sysTimers[id].context);
+				expired=TRUE;
+			}
+		}
+	}while(expired==TRUE);
+	g_dispatching=FALSE;
+
+	g_timerEvent=TRUE;
+	SysTimer_program();
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *
+ * Module: System Timer
+ *
+ * File Name: sys_timer.h
+ *
+ * Description: Header file for the tickless software timers service
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef SYS_TIMER_H_
+#define SYS_TIMER_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+#include "timestamp.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*
+ * Convert a number of milliseconds into system timer ticks (timestamp ticks), rounded to the nearest tick.
+ * The tick may be longer than 1 ms, so a short delay isn't truncated to zero. It's valid up to 71 minutes.
+ */
+#define SYS_TIMER_MS_TO_TICKS(ms)       TIMESTAMP_US_TO_TICKS(((uint32)(ms)*1000UL)+(TIMESTAMP_US_PER_TICK/2))
+
+/*
+ * Minimum distance in ticks between the counter and a programmed compare match.
+ * The counter mustn't pass the compare value while the channel is being armed, or the match is
+ * missed for a whole counter period, so a nearer deadline is delayed to this distance.
+ */
+#define SYS_TIMER_MIN_DELTA             4
+
+/*Longest distance in ticks that fits one compare match of the 16-bit counter*/
+#define SYS_TIMER_MAX_DELTA             0xFFFF
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/* Software timers of the Control ECU, each one may have a single pending deadline */
+typedef enum{
+	SYS_TIMER_DOOR,SYS_TIMER_LOCKOUT,SYS_TIMER_PWM_RAMP,SYS_TIMER_MOTION,SYS_TIMER_BUZZER,SYS_TIMER_NUM_OF_TIMERS
+}SysTimer_Id;
+
+/* Software timer call back, it's called from the Timer1 ISR with the context given at start */
+typedef void (*SysTimer_CallBackType)(void *context);
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to attach the service to the Timer1 channel A.
+ * It should be called after Timestamp_init, as the deadlines are kept in timestamp ticks.
+ */
+void SysTimer_init(void);
+
+/*
+ * Description :
+ * Function to start a software timer that expires after the given delay in ticks.
+ * If the period isn't zero the timer is re-armed by the period on every expiry, otherwise it's a one shot.
+ * Starting a running timer replaces its deadline, it's safe to call from a call back.
+ */
+void SysTimer_start(SysTimer_Id id,uint32 delay,uint32 period,SysTimer_CallBackType a_ptr,void *context);
+
+/*
+ * Description :
+ * Function to stop a software timer, it's safe to call from a call back.
+ */
+void SysTimer_stop(SysTimer_Id id);
+
+/*
+ * Description :
+ * Function to put the CPU in the idle sleep mode until the next interrupt.
+ * It returns immediately if a timer call back ran since the previous call, so a flag
+ * checked by the caller before sleeping can't be missed. It should be called with the I-bit set.
+ */
+void SysTimer_idle(void);
+
+/*
+ * Description :
+ * Function to make the next SysTimer_idle call return without sleeping.
+ * It's called by the ISRs that post work to the main context outside of a timer call back.
+ */
+void SysTimer_notify(void);
+
+#endif /* SYS_TIMER_H_ */
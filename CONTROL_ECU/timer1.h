@@ -30,6 +30,24 @@ typedef enum{
 	TIMER1_NORMAL_MODE,TIMER1_COMPARE_MODE
 }Timer1_Mode;
 
+/*Timer1 interrupt events, each one has its own call back and context*/
+typedef enum{
+	TIMER1_COMPA_EVENT,TIMER1_COMPB_EVENT,TIMER1_OVF_EVENT,TIMER1_CAPT_EVENT,TIMER1_NUM_OF_EVENTS
+}Timer1_Event;
+
+/*Timer1 compare channels, they share the counter but each one has its own period*/
+typedef enum{
+	TIMER1_CHANNEL_A,TIMER1_CHANNEL_B
+}Timer1_Channel;
+
+/*Input capture trigger edge on the ICP1 pin*/
+typedef enum{
+	TIMER1_CAPTURE_FALLING_EDGE,TIMER1_CAPTURE_RISING_EDGE
+}Timer1_CaptureEdge;
+
+/*Event call back, it receives the context registered with it*/
+typedef void (*Timer1_CallBackType)(void *context);
+
 typedef struct {
 	uint16 initial_value;
 	uint16 compare_value; // it will be used in compare mode only.
@@ -58,4 +76,43 @@ void Timer1_deInit(void);
  */
 void Timer1_setCallBack(void(*a_ptr)(void));
 
+/*
+ * Description :
+ * Function to set the call back function and its context for one Timer1 event.
+ * An event call back has priority over the common call back set by Timer1_setCallBack.
+ */
+void Timer1_setEventCallBack(Timer1_Event event,Timer1_CallBackType a_ptr,void *context);
+
+/*
+ * Description :
+ * Function to start a periodic compare channel on the running counter.
+ * The channel fires every "period" ticks counted from now, independently of the other channel.
+ * NOTE: Timer1 should be initialized in the normal mode, so the counter runs freely up to 0xFFFF.
+ */
+void Timer1_startChannel(Timer1_Channel channel,uint16 period);
+
+/*
+ * Description :
+ * Function to stop a compare channel, the other channel keeps running.
+ */
+void Timer1_stopChannel(Timer1_Channel channel);
+
+/*
+ * Description :
+ * Function to enable the input capture event on the required edge of the ICP1 pin.
+ */
+void Timer1_startCapture(Timer1_CaptureEdge edge);
+
+/*
+ * Description :
+ * Function to disable the input capture event.
+ */
+void Timer1_stopCapture(void);
+
+/*
+ * Description :
+ * Function to return the counter value latched by the last input capture event.
+ */
+uint16 Timer1_getCaptureValue(void);
+
 #endif /* TIMER1_H_ */
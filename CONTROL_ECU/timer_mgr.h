@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * Module: Timer Manager
+ *
+ * File Name: timer_mgr.h
+ *
+ * Description: Header file for the AVR hardware timers resource manager
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef TIMER_MGR_H_
+#define TIMER_MGR_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Drivers that may own the configuration (mode, prescaler, counter) of a whole timer */
+#define TIMER_OWNER_NONE                0
+#define TIMER_OWNER_TIMER1_DRIVER       1
+#define TIMER_OWNER_PWM                 2
+
+/*
+ * Compile time owner of each hardware timer.
+ * Every driver checks the owner of the timer it configures, so assigning one timer
+ * to two drivers is a build error instead of a run time clash.
+ */
+#define TIMER0_OWNER                    TIMER_OWNER_PWM
+#define TIMER1_OWNER                    TIMER_OWNER_TIMER1_DRIVER
+#define TIMER2_OWNER                    TIMER_OWNER_NONE
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/*
+ * Interrupt channels of the three timers.
+ * NOTE: Each value equals the bit number of the channel in TIMSK and TIFR.
+ */
+typedef enum{
+	TIMER0_OVF_CHANNEL,TIMER0_COMP_CHANNEL,TIMER1_OVF_CHANNEL,TIMER1_COMPB_CHANNEL,
+	TIMER1_COMPA_CHANNEL,TIMER1_CAPT_CHANNEL,TIMER2_OVF_CHANNEL,TIMER2_COMP_CHANNEL,
+	TIMER_NUM_OF_CHANNELS
+}TimerMgr_Channel;
+
+/* Services that may hold a timer channel at run time */
+typedef enum{
+	TIMER_USER_NONE,TIMER_USER_TIMER1_DRIVER,TIMER_USER_PWM
+}TimerMgr_User;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to claim a timer channel for the given user.
+ * Returns TRUE if the channel was free or already held by the same user, FALSE otherwise.
+ */
+boolean TimerMgr_claimChannel(TimerMgr_Channel channel,TimerMgr_User user);
+
+/*
+ * Description :
+ * Function to release a timer channel, only its current user can release it.
+ * The channel interrupt is disabled on release.
+ */
+void TimerMgr_releaseChannel(TimerMgr_Channel channel,TimerMgr_User user);
+
+/*
+ * Description :
+ * Function to enable the interrupt of a timer channel.
+ * TIMSK is shared by the three timers, so it's updated with an atomic read-modify-write.
+ */
+void TimerMgr_enableInterrupt(TimerMgr_Channel channel);
+
+/*
+ * Description :
+ * Function to disable the interrupt of a timer channel with an atomic read-modify-write.
+ */
+void TimerMgr_disableInterrupt(TimerMgr_Channel channel);
+
+/*
+ * Description :
+ * Function to clear the pending flag of a timer channel.
+ * TIFR flags are cleared by writing one, so only the required flag is written.
+ */
+void TimerMgr_clearFlag(TimerMgr_Channel channel);
+
+#endif /* TIMER_MGR_H_ */
@@ -60,7 +60,7 @@ void UART_init(const UART_ConfigType* Config_Ptr)
 			|(GET_BIT(Config_Ptr->bit_data,1)<<UCSZ1);
 
 	/*Calculate the value to be stored in UBRR register to select the desired baud rate*/
-	ubrr=(uint16)((float64)(UART_F_CPU)/(float64)(8*Config_Ptr->baud_rate))-1;
+	ubrr=(uint16)((uint32)(UART_F_CPU)/(8UL*Config_Ptr->baud_rate))-1;
 
 	/*
 	 * Store the higher 4 bits first, to Clear URSEL bit as well, which indicates we're writing in
@@ -1,486 +1,583 @@
-/******************************************************************************
- *
- * Title: 		Door Locker System (Control ECU)
- *
- * Description: Application code for the HMI ECU
- *
- * Author:		Mohamed Gad
- *
- * Date: 		23/6/2023
- *
- *******************************************************************************/
-/*******************************************************************************
- *                                Includes                                     *
- *******************************************************************************/
-#include "MC1.h"
-#include <avr/io.h> /*To access SREG */
-#include <util/delay.h> /*To use delay functions*/
-#include "lcd.h"
-#include "keypad.h"
-#include "timer1.h"
-#include "uart.h"
-
-/*******************************************************************************
- *                           Global Variables                                  *
- *******************************************************************************/
-/*Flag that signals the completion of Timer 1 task in the code*/
-boolean g_timer1_done=FALSE;
-
-/*Flag that indicates whether the timer is done with the delay or not*/
-boolean g_timer1_delay=FALSE;
-
-/*Dummy Configuration Structure For TIMER1*/
-Timer1_ConfigType Timer1_Config_Struct={
-		0,1,NO_PRESCALER,TIMER1_COMPARE_MODE
-};
-
-/*Timer configuration structure to be used as a delay*/
-Timer1_ConfigType Timer1_Delay_Struct={
-		0,58594,F_CPU_1024,TIMER1_COMPARE_MODE
-};
-/*******************************************************************************
- *                      Main Function Definition                               *
- *******************************************************************************/
-int main(void)
-{
-	/*Configuration Structure For UART*/
-	UART_ConfigType UART_Config_Struct={
-			No_Parity,ONE_BIT,EIGHT_BITDATA,9600
-	};
-
-	/*Variable that stores the status of the checked password (Passed, Failed,or Thief)*/
-	Password_Status Password_State;
-
-	/*
-	 * Flag responsible for executing or skipping the snippet of code that is responsible for reading and checking
-	 * The password entered by the user.
-	 */
-	boolean Password_Step_Flag=TRUE;
-
-	/*
-	 * Flag responsible for executing or skipping the snippet of code that is responsible for displaying the main
-	 * options and take input from the user. (+: open door, -: change password).
-	 */
-	boolean Options_step_flag=TRUE;
-
-	/*Variable to store the input taken from the user in the main options stage*/
-	uint8 Option_choice;
-
-	/*
-	 * String to store the password entered in the first attempt.
-	 * Note: It's of size 7 because it stores 5 chars of the password and the '#' to be able to send it via UART.
-	 */
-	uint8 pass_one[7];
-
-	/*
-	 * String to store the password entered in the second attempt.
-	 * Note: It's of size 7 because it stores 5 chars of the password and the '#' to be able to send it via UART.
-	 */
-	uint8 pass_two[7];
-
-	/********************HARDWARE INITIALIZATIONS********************/
-	LCD_init();
-	UART_init(&UART_Config_Struct);
-
-	/*Enable The global interrupts (I-bit)*/
-	SREG|=(1<<7);
-
-	/********************PROGRAM LOGIC********************/
-	while(1)
-	{
-		/*Step 1: Receive the 2 passwords entered by the user from HMI ECU*/
-		while(Password_Step_Flag==TRUE)
-		{
-			/*Enter the first password*/
-			Enter_Password(pass_one,TRUE);
-
-			/*Enter the second password*/
-			Enter_Password(pass_two, FALSE);
-
-			/*Send the first password to the Control ECU*/
-			UART_sendString(pass_one);
-
-			/*Hardware delay*/
-			_delay_ms(25);
-
-			/*Send the second password to the Control ECU*/
-			UART_sendString(pass_two);
-
-			/*Receive whether the two passwords match or not from the Control ECU*/
-			Password_State=UART_recieveByte();
-
-			if(Password_State==PASSWORD_PASSED)
-			{
-				/*If the two passwords are matched, disable step one flag (passStep_flag)*/
-				Password_Step_Flag=FALSE;
-
-				/*Enable the second step flag*/
-				Options_step_flag=TRUE;
-			}
-			else
-			{
-				/*If the two passwords aren't matched, stay at step 1*/
-				Password_Step_Flag=TRUE;
-			}
-		}
-
-		/*Step 2: display the main option to the user and get the input from him (+: Open door, -: change password_*/
-		while(Options_step_flag==TRUE)
-		{
-
-			/*Display the main options and get the input*/
-			Option_choice=Choice_Option_menu();
-
-			if(Option_choice=='+')
-			{
-				/*If the user wants to open the door, prompt him to enter the password*/
-				Enter_Password(pass_one, TRUE);
-
-				/*Send the user choice to the Control ECU*/
-				UART_sendByte('+');
-
-				/*Hardware delay*/
-				_delay_ms(25);
-
-				/*Send the entered password to the Control ECU to be compared with the one saved in the EEPROM*/
-				UART_sendString(pass_one);
-
-				/*Receive whether the password is correct or not*/
-				Password_State=UART_recieveByte();
-
-				while(Password_State==PASSWORD_FAILED)
-				{
-					LCD_clearScreen();
-					LCD_displayString("Wrong Password");
-					_delay_ms(1000);
-
-					/*If the password isn't correct, enter the password again; the user has three attempts*/
-					Enter_Password(pass_one, TRUE);
-
-					/*Hardware delay*/
-					_delay_ms(25);
-
-					/*Send the entered password to the Control ECU to be compared with the one saved in the EEPROM*/
-					UART_sendString(pass_one);
-
-					/*Receive whether the password is correct or not*/
-					Password_State=UART_recieveByte();
-				}
-
-				if(Password_State==PASSWORD_LOCKED)
-				{
-					/*If the user failed to enter the correct password three consecutive times, display an error message*/
-					LCD_clearScreen();
-					LCD_displayStringRowColumn(0, 5, "ERROR!");
-
-					/*Display the error message for 1 minute*/
-					/*Start the timer to count 1 minute*/
-					Timer1_setCallBack(callBack);
-					Timer1_init(&Timer1_Delay_Struct);
-					g_timer1_delay=TRUE;
-
-					/*Wait until the timer is done*/
-					while(g_timer1_delay==TRUE);
-
-					/*Continue to return to the main options menu again*/
-					continue;
-				}
-				else if(Password_State==PASSWORD_PASSED)
-				{
-					/*Else if the the password is correct, start the timer to display the door state (unlocking, unlocked, locking)*/
-					Timer1_setCallBack(callBack);
-					Timer1_init(&Timer1_Config_Struct);
-
-					/*Wait until the door is done opening and closing, .i.e, the time has finished*/
-					while(!g_timer1_done);
-
-					/*Reset the timer flag*/
-					g_timer1_done=FALSE;
-
-					/*Continue to return to the main options menu again*/
-					continue;
-				}
-				else
-				{
-					/*Do Nothing*/
-				}
-			}
-			else  if(Option_choice=='-')
-			{
-				/*If the user want to change the password, the user is prompted to enter the saved password first*/
-				Enter_Password(pass_one, TRUE);
-
-				/*Send the user choice to the Control ECU*/
-				UART_sendByte('-');
-
-				/*Hardware delay*/
-				_delay_ms(25);
-
-				/*Send the entered password to the control ECU to be checked*/
-				UART_sendString(pass_one);
-
-				/*Receive whether the password is correct or not*/
-				Password_State=UART_recieveByte();
-
-				while(Password_State==PASSWORD_FAILED)
-				{
-					LCD_clearScreen();
-					LCD_displayString("Wrong Password");
-					_delay_ms(1000);
-
-					/*If the password isn't correct, enter the password again; the user has three attempts*/
-					Enter_Password(pass_one, TRUE);
-
-					/*Hardware delay*/
-					_delay_ms(25);
-
-					/*Send the entered password to the control ECU to be checked*/
-					UART_sendString(pass_one);
-
-					/*Receive whether the password is correct or not*/
-					Password_State=UART_recieveByte();
-				}
-
-				if(Password_State==PASSWORD_LOCKED)
-				{
-					/*If the user failed to enter the correct password three consecutive times, display an error message*/
-					LCD_clearScreen();
-					LCD_displayStringRowColumn(0, 5, "ERROR!");
-
-					/*Display the error message for 1 minute*/
-					/*Start the timer to count 1 minute*/
-					Timer1_setCallBack(callBack);
-					Timer1_init(&Timer1_Delay_Struct);
-					g_timer1_delay=TRUE;
-
-					/*Wait until the timer is done*/
-					while(g_timer1_delay==TRUE);
-
-					/*Continue to return to the main options menu again*/
-					continue;
-				}
-				else if(Password_State==PASSWORD_PASSED)
-				{
-					LCD_clearScreen();
-					LCD_displayString("Correct Password");
-					LCD_displayStringRowColumn(1, 0, "Reset Password");
-					_delay_ms(1000);
-
-					/*If the password is correct, enable step one flag to return to reset password step*/
-					Password_Step_Flag=TRUE;
-
-					/*Disable step 2 flag for now*/
-					Options_step_flag=FALSE;
-				}
-				else
-				{
-					/*Do Nothing*/
-				}
-			}
-			else
-			{
-				/*Do Nothing*/
-			}
-		}
-	}
-}
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-
-/*
- * Description :
- * This function display a prompt to the user to enter the password whether to save it or to store it in EEPROM.
- */
-void Enter_Password(uint8* pass,boolean isFirst)
-{
-	/*Variable to index the characters in the password to be saved*/
-	uint8 pass_counter=0;
-
-	/*Variable to store the ascii of the pressed key on the keypad*/
-	uint8 Key;
-
-	if(isFirst==1)
-	{
-		/*If this is password 1, display messages related to this password*/
-		LCD_clearScreen();
-		LCD_displayString("Plz Enter Pass: ");
-		LCD_moveCursor(1, 0);
-	}
-	else
-	{
-		/*Else if this is password 2, prompt the user to reenter the same password entered at first*/
-		LCD_clearScreen();
-		LCD_displayString("Plz Re-Enter the");
-		LCD_moveCursor(1, 0);
-		LCD_displayString("Same Pass:");
-	}
-
-	/*Loop to get and store the entered password using keypad*/
-	for(pass_counter=0;pass_counter<PASSWORD_LIMIT;pass_counter++)
-	{
-		/*Get ascii of the pressed key*/
-		Key=KEYPAD_getPressedKey();
-
-		if(Key=='=')
-		{
-			/*If the user pressed enter, add the '#' at the end of the string to be able to send it via UART to the Control ECU*/
-			pass[pass_counter]='#';
-
-			/*Lastly, add the null terminator '\0'*/
-			pass[pass_counter+1]='\0';
-
-			/*End the loop*/
-			break;
-		}
-
-		if(pass_counter==5)
-		{
-			/*At character number 6, wait for the user to press enter ('=')*/
-			if(Key=='=')
-			{
-				/*If the user pressed enter, add the '#' at the end of the string to be able to send it via UART to the Control ECU*/
-				pass[pass_counter]='#';
-
-				/*Lastly, add the null terminator '\0'*/
-				pass[pass_counter+1]='\0';
-
-				/*End the loop*/
-				break;
-			}
-			else
-			{
-				/*If the user pressed any key other than enter, reduce the counter then continue, until the user hits enter*/
-				pass_counter=4;
-				continue;
-			}
-		}
-		else
-		{
-			/*Save the entered characters in the password string*/
-			pass[pass_counter]=Key;
-
-			/*Display '*' on the LCD with each character taken from user */
-			LCD_displayCharacter('*');
-		}
-
-		/*Hardware delay*/
-		_delay_ms(500);
-	}
-}
-
-/*
- * Description :
- * This function display the main options on the LCD, and takes input from the user then return that input.
- */
-uint8 Choice_Option_menu(void)
-{
-	/*Variable to store ascii of pressed key, and boolean to control the while loop*/
-	uint8 pressed_key,bool=TRUE;
-
-	/*To store the pressed key again, but this one is used in return statement*/
-	uint8 choice;
-
-	/*Display main options on LCD*/
-	LCD_clearScreen();
-	LCD_displayString("+ : Open Door");
-	LCD_moveCursor(1, 0);
-	LCD_displayString("- : Change Pass");
-
-	while(bool)
-	{
-		/*Get the key*/
-		pressed_key=KEYPAD_getPressedKey();
-		switch (pressed_key)
-		{
-		case '+':
-			/*get out of the loop only if user chooses '+' or '-'*/
-			bool=FALSE;
-			choice= '+';
-			break;
-		case '-':
-			bool=FALSE;
-			choice='-';
-			break;
-		default:
-			/*If any thing other than '+' and  '-' button is pressed, do nothing*/
-			bool=TRUE;
-			break;
-		}
-		/*Hardware delay*/
-		_delay_ms(100);
-	}
-
-	/*Return ascii of the pressed key*/
-	return choice;
-}
-
-/*
- * Description :
- * This is the callBack Function that'll be called when an interrupt request is generated
- * by Timer1.
- */
-void callBack(void)
-{
-	static sint8 state_counter=1;
-
-	/*Ask whether we want to use timer as delay to display error message, or use it to count time of motor opening and closing*/
-	if(g_timer1_delay==TRUE)
-	{
-		/*If the delay is done, reset everything*/
-		g_timer1_delay=FALSE;
-		Timer1_deInit();
-	}
-	else
-	{
-		switch (state_counter)
-		{
-		case 1:
-			/*Configure timer to count 15 seconds, during which "Door is unlocking" is displayed on LCD*/
-			state_counter++;
-			LCD_clearScreen();
-			LCD_displayStringRowColumn(0, 5, "Door is ");
-			LCD_displayStringRowColumn(1, 5, "Unlocking");
-			Timer1_Config_Struct.mode=TIMER1_COMPARE_MODE;
-			Timer1_Config_Struct.prescaler=F_CPU_1024;
-			Timer1_Config_Struct.compare_value=14649;
-			Timer1_Config_Struct.initial_value=0;
-			Timer1_init(&Timer1_Config_Struct);
-			break;
-		case 2:
-			/*Configure timer to count 3 seconds, during which "Door is unlocked" is displayed on LCD*/
-			state_counter++;
-			LCD_clearScreen();
-			LCD_displayString("Door Unlocked");
-			Timer1_Config_Struct.compare_value=2930;
-			Timer1_Config_Struct.initial_value=0;
-			Timer1_init(&Timer1_Config_Struct);
-			break;
-		case 3:
-			/*Configure timer to count 15 seconds, during which "Door is locking" is displayed on LCD*/
-			state_counter++;
-			LCD_clearScreen();
-			LCD_displayStringRowColumn(0, 5, "Door is ");
-			LCD_displayStringRowColumn(1, 5, "Locking");
-			Timer1_Config_Struct.compare_value=14649;
-			Timer1_Config_Struct.initial_value=0;
-			Timer1_init(&Timer1_Config_Struct);
-			break;
-		case 4:
-			/*Reset everything and deinit the timer*/
-			state_counter=1;
-
-			/*Dummy configurations to start the timer with in the next time*/
-			Timer1_Config_Struct.compare_value=1;
-			Timer1_Config_Struct.initial_value=0;
-			Timer1_Config_Struct.mode=TIMER1_COMPARE_MODE;
-			Timer1_Config_Struct.prescaler=NO_PRESCALER;
-
-			/*Signal that timer has finished to get out of the infinite loop*/
-			g_timer1_done=TRUE;
-			Timer1_deInit();
-			break;
-		}
-	}
-}
+/******************************************************************************
+ *
+ * Title: 		Door Locker System (Control ECU)
+ *
+ * Description: Application code for the HMI ECU
+ *
+ * Author:		Mohamed Gad
+ *
+ * Date: 		23/6/2023
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "MC1.h"
+#include <avr/io.h> /*To access SREG */
+#include <util/delay.h> /*To use delay functions*/
+#include "board.h"
+#include "lcd.h"
+#include "keypad.h"
+#include "uart.h"
+#include "timestamp.h"
+#include "sys_timer.h"
+#include "messages.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Last door state reported by the Control ECU, waiting to be rendered*/
+Door_Event g_door_event=DOOR_NO_EVENT;
+
+/*Flag set by the lockout timer when the next lockout state request is due*/
+volatile boolean g_lockout_poll_due=FALSE;
+
+/*Flag set when no door report came in DOOR_REPORT_TIMEOUT_MS*/
+volatile boolean g_door_timeout=FALSE;
+
+/*******************************************************************************
+ *                      Main Function Definition                               *
+ *******************************************************************************/
+int main(void)
+{
+	/*Configuration Structure For UART*/
+	UART_ConfigType UART_Config_Struct={
+			No_Parity,ONE_BIT,EIGHT_BITDATA,9600
+	};
+
+	/*Variable that stores the status of the checked password (Passed, Failed,or Thief)*/
+	Password_Status Password_State;
+
+	/*
+	 * Flag responsible for executing or skipping the snippet of code that is responsible for reading and checking
+	 * The password entered by the user.
+	 */
+	boolean Password_Step_Flag=TRUE;
+
+	/*
+	 * Flag responsible for executing or skipping the snippet of code that is responsible for displaying the main
+	 * options and take input from the user. (+: open door, -: change password).
+	 */
+	boolean Options_step_flag=TRUE;
+
+	/*Variable to store the input taken from the user in the main options stage*/
+	uint8 Option_choice;
+
+	/*
+	 * String to store the password entered in the first attempt.
+	 * Note: It's of size 7 because it stores 5 chars of the password and the '#' to be able to send it via UART.
+	 */
+	uint8 pass_one[7];
+
+	/*
+	 * String to store the password entered in the second attempt.
+	 * Note: It's of size 7 because it stores 5 chars of the password and the '#' to be able to send it via UART.
+	 */
+	uint8 pass_two[7];
+
+	/*Variable to store a byte received from the Control ECU while waiting for the door reports*/
+	uint8 received_byte;
+
+	/********************HARDWARE INITIALIZATIONS********************/
+	Board_init();
+	LCD_init();
+	KEYPAD_init();
+	UART_init(&UART_Config_Struct);
+	Timestamp_init();
+	SysTimer_init();
+
+	/*Enable The global interrupts (I-bit)*/
+	SREG|=(1<<7);
+
+	/********************PROGRAM LOGIC********************/
+	while(1)
+	{
+		/*Step 1: Receive the 2 passwords entered by the user from HMI ECU*/
+		while(Password_Step_Flag==TRUE)
+		{
+			/*Enter the first password*/
+			Enter_Password(pass_one,TRUE);
+
+			/*Enter the second password*/
+			Enter_Password(pass_two, FALSE);
+
+			/*Send the first password to the Control ECU*/
+			UART_sendString(pass_one);
+
+			/*Hardware delay*/
+			_delay_ms(25);
+
+			/*Send the second password to the Control ECU*/
+			UART_sendString(pass_two);
+
+			/*Receive whether the two passwords match or not from the Control ECU*/
+			Password_State=UART_recieveByte();
+
+			if(Password_State==PASSWORD_PASSED)
+			{
+				/*If the two passwords are matched, disable step one flag (passStep_flag)*/
+				Password_Step_Flag=FALSE;
+
+				/*Enable the second step flag*/
+				Options_step_flag=TRUE;
+			}
+			else
+			{
+				/*If the two passwords aren't matched, stay at step 1*/
+				Password_Step_Flag=TRUE;
+			}
+		}
+
+		/*Step 2: display the main option to the user and get the input from him (+: Open door, -: change password_*/
+		while(Options_step_flag==TRUE)
+		{
+
+			/*Display the main options and get the input*/
+			Option_choice=Choice_Option_menu();
+
+			if(Option_choice=='+')
+			{
+				/*If the user wants to open the door, prompt him to enter the password*/
+				Enter_Password(pass_one, TRUE);
+
+				/*Send the user choice to the Control ECU*/
+				UART_sendByte('+');
+
+				/*Hardware delay*/
+				_delay_ms(25);
+
+				/*Send the entered password to the Control ECU to be compared with the one saved in the EEPROM*/
+				UART_sendString(pass_one);
+
+				/*Receive whether the password is correct or not*/
+				Password_State=UART_recieveByte();
+
+				while(Password_State==PASSWORD_FAILED)
+				{
+					LCD_fbClear();
+					LCD_fbWrite_P(0, 0, Messages_get(MSG_WRONG_PASS));
+					LCD_fbFlush();
+					_delay_ms(1000);
+
+					/*If the password isn't correct, enter the password again; the user has three attempts*/
+					Enter_Password(pass_one, TRUE);
+
+					/*Hardware delay*/
+					_delay_ms(25);
+
+					/*Send the entered password to the Control ECU to be compared with the one saved in the EEPROM*/
+					UART_sendString(pass_one);
+
+					/*Receive whether the password is correct or not*/
+					Password_State=UART_recieveByte();
+				}
+
+				if(Password_State==PASSWORD_LOCKED)
+				{
+					/*If the user failed to enter the correct password three consecutive times, display an error message until the lockout is over*/
+					Wait_Lockout();
+
+					/*The keys pressed during the lockout are dropped, the user starts over from the menu*/
+					KEYPAD_flush();
+
+					/*Continue to return to the main options menu again*/
+					continue;
+				}
+				else if(Password_State==PASSWORD_PASSED)
+				{
+					/*
+					 * Else if the the password is correct, display the door state (unlocking, unlocked, locking).
+					 * The stages take as long as the door mechanism needs, the Control ECU reports the end of each one.
+					 */
+					g_door_event=DOOR_UNLOCKING;
+					Display_Door_State();
+
+					/*
+					 * Wait until the door is done opening and closing, .i.e, the door is locked.
+					 * Each report restarts the deadline, and a byte that isn't a door report is dropped.
+					 * The CPU sleeps between the reports, the UART RX ISR and the deadline wake it up.
+					 */
+					g_door_timeout=FALSE;
+					SysTimer_start(SYS_TIMER_DOOR, SYS_TIMER_MS_TO_TICKS(DOOR_REPORT_TIMEOUT_MS), 0, doorTimeoutCallBack, NULL_PTR);
+					do
+					{
+						if(UART_tryRecieveByte(&received_byte)==FALSE)
+						{
+							SysTimer_idle();
+						}
+						else if((received_byte>=DOOR_UNLOCKING) && (received_byte<=DOOR_LOCKED))
+						{
+							g_door_event=received_byte;
+							Display_Door_State();
+							SysTimer_start(SYS_TIMER_DOOR, SYS_TIMER_MS_TO_TICKS(DOOR_REPORT_TIMEOUT_MS), 0, doorTimeoutCallBack, NULL_PTR);
+						}
+						else
+						{
+							/*Do Nothing*/
+						}
+					}while((g_door_event!=DOOR_LOCKED) && (g_door_timeout==FALSE));
+					SysTimer_stop(SYS_TIMER_DOOR);
+
+					if(g_door_timeout==TRUE)
+					{
+						/*The Control ECU is lost, report it and drop what it sent so the next request starts clean*/
+						LCD_fbClear();
+						LCD_fbWrite_P(0, 5, Messages_get(MSG_ERROR));
+						LCD_fbWrite_P(1, 1, Messages_get(MSG_NO_DOOR_REPORT));
+						LCD_fbFlush();
+						_delay_ms(1000);
+						UART_flush();
+					}
+					else
+					{
+						/*Do Nothing*/
+					}
+
+					/*Continue to return to the main options menu again*/
+					continue;
+				}
+				else
+				{
+					/*Do Nothing*/
+				}
+			}
+			else  if(Option_choice=='-')
+			{
+				/*If the user want to change the password, the user is prompted to enter the saved password first*/
+				Enter_Password(pass_one, TRUE);
+
+				/*Send the user choice to the Control ECU*/
+				UART_sendByte('-');
+
+				/*Hardware delay*/
+				_delay_ms(25);
+
+				/*Send the entered password to the control ECU to be checked*/
+				UART_sendString(pass_one);
+
+				/*Receive whether the password is correct or not*/
+				Password_State=UART_recieveByte();
+
+				while(Password_State==PASSWORD_FAILED)
+				{
+					LCD_fbClear();
+					LCD_fbWrite_P(0, 0, Messages_get(MSG_WRONG_PASS));
+					LCD_fbFlush();
+					_delay_ms(1000);
+
+					/*If the password isn't correct, enter the password again; the user has three attempts*/
+					Enter_Password(pass_one, TRUE);
+
+					/*Hardware delay*/
+					_delay_ms(25);
+
+					/*Send the entered password to the control ECU to be checked*/
+					UART_sendString(pass_one);
+
+					/*Receive whether the password is correct or not*/
+					Password_State=UART_recieveByte();
+				}
+
+				if(Password_State==PASSWORD_LOCKED)
+				{
+					/*If the user failed to enter the correct password three consecutive times, display an error message until the lockout is over*/
+					Wait_Lockout();
+
+					/*The keys pressed during the lockout are dropped, the user starts over from the menu*/
+					KEYPAD_flush();
+
+					/*Continue to return to the main options menu again*/
+					continue;
+				}
+				else if(Password_State==PASSWORD_PASSED)
+				{
+					LCD_fbClear();
+					LCD_fbWrite_P(0, 0, Messages_get(MSG_CORRECT_PASS));
+					LCD_fbWrite_P(1, 0, Messages_get(MSG_RESET_PASS));
+					LCD_fbFlush();
+					_delay_ms(1000);
+
+					/*If the password is correct, enable step one flag to return to reset password step*/
+					Password_Step_Flag=TRUE;
+
+					/*Disable step 2 flag for now*/
+					Options_step_flag=FALSE;
+				}
+				else
+				{
+					/*Do Nothing*/
+				}
+			}
+			else
+			{
+				/*Do Nothing*/
+			}
+		}
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * This function display a prompt to the user to enter the password whether to save it or to store it in EEPROM.
+ */
+void Enter_Password(uint8* pass,boolean isFirst)
+{
+	/*Variable to index the characters in the password to be saved*/
+	uint8 pass_counter=0;
+
+	/*Variable to store the ascii of the pressed key on the keypad*/
+	uint8 Key;
+
+	/*Column of the first '*' on the second row of the LCD*/
+	uint8 star_col;
+
+	LCD_fbClear();
+	if(isFirst==1)
+	{
+		/*If this is password 1, display messages related to this password*/
+		LCD_fbWrite_P(0, 0, Messages_get(MSG_ENTER_PASS));
+		star_col=0;
+	}
+	else
+	{
+		/*Else if this is password 2, prompt the user to reenter the same password entered at first*/
+		LCD_fbWrite_P(0, 0, Messages_get(MSG_REENTER_PASS));
+		LCD_fbWrite_P(1, 0, Messages_get(MSG_SAME_PASS));
+		star_col=10;
+	}
+	LCD_fbFlush();
+
+	/*Loop to get and store the entered password using keypad*/
+	for(pass_counter=0;pass_counter<PASSWORD_LIMIT;pass_counter++)
+	{
+		/*Get ascii of the pressed key*/
+		Key=KEYPAD_getPressedKey();
+
+		if(Key=='=')
+		{
+			/*If the user pressed enter, add the '#' at the end of the string to be able to send it via UART to the Control ECU*/
+			pass[pass_counter]='#';
+
+			/*Lastly, add the null terminator '\0'*/
+			pass[pass_counter+1]='\0';
+
+			/*End the loop*/
+			break;
+		}
+
+		if(pass_counter==5)
+		{
+			/*At character number 6, wait for the user to press enter ('=')*/
+			if(Key=='=')
+			{
+				/*If the user pressed enter, add the '#' at the end of the string to be able to send it via UART to the Control ECU*/
+				pass[pass_counter]='#';
+
+				/*Lastly, add the null terminator '\0'*/
+				pass[pass_counter+1]='\0';
+
+				/*End the loop*/
+				break;
+			}
+			else
+			{
+				/*If the user pressed any key other than enter, reduce the counter then continue, until the user hits enter*/
+				pass_counter=4;
+				continue;
+			}
+		}
+		else
+		{
+			/*Save the entered characters in the password string*/
+			pass[pass_counter]=Key;
+
+			/*Display '*' on the LCD with each character taken from user */
+			LCD_fbWrite(1, star_col+pass_counter, "*");
+			LCD_fbFlush();
+		}
+	}
+}
+
+/*
+ * Description :
+ * This function display the main options on the LCD, and takes input from the user then return that input.
+ */
+uint8 Choice_Option_menu(void)
+{
+	/*Variable to store ascii of pressed key, and boolean to control the while loop*/
+	uint8 pressed_key,bool=TRUE;
+
+	/*To store the pressed key again, but this one is used in return statement*/
+	uint8 choice;
+
+	/*Flag to display the main options again after another screen*/
+	boolean redraw=TRUE;
+
+	while(bool)
+	{
+		if(redraw)
+		{
+			/*Display main options on LCD*/
+			LCD_fbClear();
+			LCD_fbWrite_P(0, 0, Messages_get(MSG_OPEN_DOOR_OPTION));
+			LCD_fbWrite_P(1, 0, Messages_get(MSG_CHANGE_PASS_OPTION));
+			LCD_fbFlush();
+			redraw=FALSE;
+		}
+
+		/*Get the key*/
+		pressed_key=KEYPAD_getPressedKey();
+		switch (pressed_key)
+		{
+		case '+':
+			/*get out of the loop only if user chooses '+' or '-'*/
+			bool=FALSE;
+			choice= '+';
+			break;
+		case '-':
+			bool=FALSE;
+			choice='-';
+			break;
+#if (TIMER1_ISR_PROFILING == 1)
+		case '*':
+			/*Read out the Timer1 ISR profiling, then back to the main options*/
+			Display_Isr_Profile();
+			redraw=TRUE;
+			break;
+#endif
+		default:
+			/*If any thing other than '+' and  '-' button is pressed, do nothing*/
+			bool=TRUE;
+			break;
+		}
+	}
+
+	/*Return ascii of the pressed key*/
+	return choice;
+}
+
+#if (TIMER1_ISR_PROFILING == 1)
+/*
+ * Description :
+ * This function displays the worst-case Timer1 ISR duration measured so far, until a key is pressed.
+ * The value is in Timer0 ticks of 8 CPU cycles, 255 means an ISR ran for 256 ticks or more.
+ */
+void Display_Isr_Profile(void)
+{
+	/*Worst-case ticks and their text in 3 digits*/
+	uint8 max_ticks=Timer1_getIsrMaxTicks();
+	char ticks_text[4];
+
+	ticks_text[0]='0'+max_ticks/100;
+	ticks_text[1]='0'+(max_ticks/10)%10;
+	ticks_text[2]='0'+max_ticks%10;
+	ticks_text[3]='\0';
+
+	LCD_fbClear();
+	LCD_fbWrite_P(0, 0, Messages_get(MSG_ISR_MAX_TICKS));
+	LCD_fbWrite(1, 0, ticks_text);
+	LCD_fbFlush();
+
+	KEYPAD_getPressedKey();
+}
+#endif
+
+/*
+ * Description :
+ * This function takes the last door state and renders it on the LCD.
+ * The LCD frame is flushed by the LCD queue in the background, so the next report can be received at once.
+ */
+void Display_Door_State(void)
+{
+	switch (g_door_event)
+	{
+	case DOOR_UNLOCKING:
+		LCD_fbClear();
+		LCD_fbWrite_P(0, 5, Messages_get(MSG_DOOR_IS));
+		LCD_fbWrite_P(1, 5, Messages_get(MSG_UNLOCKING));
+		LCD_fbFlush();
+		break;
+	case DOOR_UNLOCKED:
+		LCD_fbClear();
+		LCD_fbWrite_P(0, 0, Messages_get(MSG_DOOR_UNLOCKED));
+		LCD_fbFlush();
+		break;
+	case DOOR_LOCKING:
+		LCD_fbClear();
+		LCD_fbWrite_P(0, 5, Messages_get(MSG_DOOR_IS));
+		LCD_fbWrite_P(1, 5, Messages_get(MSG_LOCKING));
+		LCD_fbFlush();
+		break;
+	default:
+		/*No new door state to render*/
+		break;
+	}
+}
+
+/*
+ * Description :
+ * This function displays the error message with the seconds left of the lockout, it asks the Control ECU
+ * for the lockout state every second and returns once the lockout is over.
+ * The Control ECU keeps the lockout time, so the count shown is always the real one.
+ */
+void Wait_Lockout(void)
+{
+	/*Lockout state and seconds left as replied by the Control ECU, and the seconds text right aligned in 3 digits*/
+	Lockout_Status lockout_state;
+	uint8 seconds_left;
+	char seconds_text[4];
+
+	LCD_fbClear();
+	LCD_fbWrite_P(0, 5, Messages_get(MSG_ERROR));
+	LCD_fbWrite_P(1, 3, Messages_get(MSG_SECONDS_LEFT));
+
+	/*Ask for the lockout state, the Control ECU answers at once*/
+	UART_sendByte(LOCKOUT_STATUS_REQUEST);
+	lockout_state=UART_recieveByte();
+
+	while(lockout_state==LOCKOUT_ACTIVE)
+	{
+		seconds_left=UART_recieveByte();
+
+		seconds_text[0]=(seconds_left>=100)?('0'+seconds_left/100):' ';
+		seconds_text[1]=(seconds_left>=10)?('0'+(seconds_left/10)%10):' ';
+		seconds_text[2]='0'+seconds_left%10;
+		seconds_text[3]='\0';
+		LCD_fbWrite(1, 0, seconds_text);
+		LCD_fbFlush();
+
+		/*Sleep until the next request*/
+		g_lockout_poll_due=FALSE;
+		SysTimer_start(SYS_TIMER_LOCKOUT, SYS_TIMER_MS_TO_TICKS(LOCKOUT_POLL_TIME_MS), 0, lockoutCallBack, NULL_PTR);
+		while(g_lockout_poll_due==FALSE)
+		{
+			SysTimer_idle();
+		}
+
+		UART_sendByte(LOCKOUT_STATUS_REQUEST);
+		lockout_state=UART_recieveByte();
+	}
+}
+
+/*
+ * Description :
+ * This is the call back function of the lockout timer, it ends the wait between two lockout state requests.
+ */
+void lockoutCallBack(void *context)
+{
+	/*The wait is over, the next request is due*/
+	g_lockout_poll_due=TRUE;
+}
+
+/*
+ * Description :
+ * This is the call back function of the door report timer, it ends the wait for the next door report.
+ */
+void doorTimeoutCallBack(void *context)
+{
+	g_door_timeout=TRUE;
+}
@@ -1,50 +1,108 @@
-/******************************************************************************
- *
- * Module: HMI ECU
- *
- * File Name: HMI_ECU.h
- *
- * Description: Header file for the HMI ECU.
- *
- * Author: Mohamed Gad
- *
- *******************************************************************************/
-
-#ifndef HMI_ECU_H_
-#define HMI_ECU_H_
-
-#include "std_types.h"
-
-
-#define PASSWORD_LIMIT 6
-#define F_CPU		   1000000UL
-/*******************************************************************************
- *                         Types Declaration                                   *
- *******************************************************************************/
-typedef enum{
-	PASSWORD_FAILED,PASSWORD_PASSED,PASSWORD_LOCKED
-}Password_Status;
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-/*
- * Description :
- * This function display a prompt to the user to enter the password whether to save it or to store it in EEPROM.
- */
-void Enter_Password(uint8* pass,boolean isFirst);
-
-/*
- * Description :
- * This function display the main options on the LCD, and takes input from the user then return that input.
- */
-uint8 Choice_Option_menu(void);
-
-/*
- * Description :
- * This is the callBack Function that'll be called when an interrupt request is generated
- * by Timer1.
- */
-void callBack(void);
-
-#endif /* HMI_ECU_H_ */
+/******************************************************************************
+ *
+ * Module: HMI ECU
+ *
+ * File Name: HMI_ECU.h
+ *
+ * Description: Header file for the HMI ECU.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef HMI_ECU_H_
+#define HMI_ECU_H_
+
+#include "std_types.h"
+#include "timer1.h" /*To know whether the Timer1 ISR profiling is enabled*/
+
+
+#define PASSWORD_LIMIT 6
+#define F_CPU		   1000000UL
+
+/*Durations in milliseconds of the system timer tasks*/
+#define LOCKOUT_POLL_TIME_MS	1000
+
+/*
+ * Longest wait for the next door report, the longest stage of the Control ECU door cycle is a travel
+ * with its overrun time (18 s). Without a report by then the Control ECU is taken as lost, an error is
+ * shown and the bytes received so far are dropped before the next request.
+ */
+#define DOOR_REPORT_TIMEOUT_MS	25000
+
+/*Request sent to the Control ECU to get the lockout state, it's answered at once even during the lockout*/
+#define LOCKOUT_STATUS_REQUEST	'?'
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum{
+	PASSWORD_FAILED,PASSWORD_PASSED,PASSWORD_LOCKED
+}Password_Status;
+
+/*
+ * Lockout state replied by the Control ECU, LOCKOUT_ACTIVE is followed by the seconds left.
+ * The codes differ from the password states and the door states, so a lockout reply read where a password
+ * state is expected is never taken for PASSWORD_PASSED.
+ */
+typedef enum{
+	LOCKOUT_INACTIVE=0xA0,LOCKOUT_ACTIVE=0xA1
+}Lockout_Status;
+
+/*
+ * Door states reported by the Control ECU at the end of each stage of the door cycle, rendered on the LCD.
+ * The codes differ from the password and lockout states, so a late report is never taken for the reply of a request.
+ */
+typedef enum{
+	DOOR_NO_EVENT=0xB0,DOOR_UNLOCKING,DOOR_UNLOCKED,DOOR_LOCKING,DOOR_LOCKED
+}Door_Event;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * This function display a prompt to the user to enter the password whether to save it or to store it in EEPROM.
+ */
+void Enter_Password(uint8* pass,boolean isFirst);
+
+/*
+ * Description :
+ * This function display the main options on the LCD, and takes input from the user then return that input.
+ */
+uint8 Choice_Option_menu(void);
+
+#if (TIMER1_ISR_PROFILING == 1)
+/*
+ * Description :
+ * This function displays the worst-case Timer1 ISR duration measured so far, until a key is pressed.
+ */
+void Display_Isr_Profile(void);
+#endif
+
+/*
+ * Description :
+ * This function takes the last door state and renders it on the LCD.
+ */
+void Display_Door_State(void);
+
+/*
+ * Description :
+ * This function displays the error message with the seconds left of the lockout, it asks the Control ECU
+ * for the lockout state every second and returns once the lockout is over.
+ */
+void Wait_Lockout(void);
+
+/*
+ * Description :
+ * This is the call back function of the lockout timer, it ends the wait between two lockout state requests.
+ */
+void lockoutCallBack(void *context);
+
+/*
+ * Description :
+ * This is the call back function of the door report timer, it ends the wait for the next door report.
+ */
+void doorTimeoutCallBack(void *context);
+
+#endif /* HMI_ECU_H_ */
@@ -0,0 +1,108 @@
+/******************************************************************************
+ *
+ * Module: Board
+ *
+ * File Name: board.c
+ *
+ * Description: Source file for the boot pin configuration of the HMI ECU board
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "board.h"
+#include "keypad.h" /*To use the keypad pressed level*/
+#include <avr/io.h> /*To use the IO Ports Registers*/
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Pin directions in the board table, the GPIO enums can't be used in the preprocessor checks*/
+#define BOARD_INPUT                 0
+#define BOARD_OUTPUT                1
+
+/*LCD entries, they depend on the RW connection and the data bits mode*/
+#if (LCD_RW_CONNECTED == TRUE)
+#define BOARD_LCD_RW_PINS(X,port) \
+	X(port, LCD_RW_PORT_ID, (1<<LCD_RW_PIN_ID), BOARD_OUTPUT, LOGIC_LOW)
+#else
+#define BOARD_LCD_RW_PINS(X,port)
+#endif
+
+#if (LCD_DATA_BITS_MODE == 4)
+#define BOARD_LCD_DATA_PINS(X,port) \
+	X(port, LCD_DATA_PORT_ID, (1<<LCD_DB4_PIN_ID), BOARD_OUTPUT, LOGIC_LOW) \
+	X(port, LCD_DATA_PORT_ID, (1<<LCD_DB5_PIN_ID), BOARD_OUTPUT, LOGIC_LOW) \
+	X(port, LCD_DATA_PORT_ID, (1<<LCD_DB6_PIN_ID), BOARD_OUTPUT, LOGIC_LOW) \
+	X(port, LCD_DATA_PORT_ID, (1<<LCD_DB7_PIN_ID), BOARD_OUTPUT, LOGIC_LOW)
+#else
+#define BOARD_LCD_DATA_PINS(X,port) \
+	X(port, LCD_DATA_PORT_ID, 0xFF, BOARD_OUTPUT, LOGIC_LOW)
+#endif
+
+/*
+ * Board table, one entry for every pin or group of pins of one port:
+ * X(port, port id, pins mask, direction, level)
+ * The level of an output pin is its boot value, a high level on an input pin enables its pull-up.
+ * It's expanded once per port, the entries of other ports add nothing to the result.
+ * The keypad rows boot driven active, ready for the wake up interrupt, and the columns have external pull-ups.
+ */
+#define BOARD_PINS(X,port) \
+	X(port, LCD_RS_PORT_ID, (1<<LCD_RS_PIN_ID), BOARD_OUTPUT, LOGIC_LOW) \
+	X(port, LCD_E_PORT_ID, (1<<LCD_E_PIN_ID), BOARD_OUTPUT, LOGIC_LOW) \
+	BOARD_LCD_RW_PINS(X,port) \
+	BOARD_LCD_DATA_PINS(X,port) \
+	X(port, KEYPAD_ROW_PORT_ID, (((1<<KEYPAD_NUM_ROWS)-1)<<KEYPAD_FIRST_ROW_PIN_ID), BOARD_OUTPUT, KEYPAD_BUTTON_PRESSED) \
+	X(port, KEYPAD_COL_PORT_ID, (((1<<KEYPAD_NUM_COLS)-1)<<KEYPAD_FIRST_COL_PIN_ID), BOARD_INPUT, LOGIC_LOW) \
+	X(port, KEYPAD_INT_PORT_ID, (1<<KEYPAD_INT_PIN_ID), BOARD_INPUT, LOGIC_LOW) \
+	X(port, UART_RXD_PORT_ID, (1<<UART_RXD_PIN_ID), BOARD_INPUT, LOGIC_LOW) \
+	X(port, UART_TXD_PORT_ID, (1<<UART_TXD_PIN_ID), BOARD_OUTPUT, LOGIC_HIGH)
+
+/*Table entry helpers, each one returns the mask of the entry if it's on the required port*/
+#define BOARD_SUM_MASK(port,port_num,mask,direction,level)     +(((port_num) == (port)) ? (mask) : 0)
+#define BOARD_OR_MASK(port,port_num,mask,direction,level)      |(((port_num) == (port)) ? (mask) : 0)
+#define BOARD_DDR_MASK(port,port_num,mask,direction,level)     |((((port_num) == (port)) && ((direction) == BOARD_OUTPUT)) ? (mask) : 0)
+#define BOARD_PORT_MASK(port,port_num,mask,direction,level)    |((((port_num) == (port)) && ((level) == LOGIC_HIGH)) ? (mask) : 0)
+
+/*Pins used on a port, the sum equals the mask only if no pin is assigned twice*/
+#define BOARD_USED_SUM(port)        (0 BOARD_PINS(BOARD_SUM_MASK,port))
+#define BOARD_USED_MASK(port)       (0 BOARD_PINS(BOARD_OR_MASK,port))
+
+/*Boot values of the port registers, the unused pins are inputs without pull-up*/
+#define BOARD_DDR_VALUE(port)       (0 BOARD_PINS(BOARD_DDR_MASK,port))
+#define BOARD_PORT_VALUE(port)      (0 BOARD_PINS(BOARD_PORT_MASK,port))
+
+/*******************************************************************************
+ *                      Preprocessor Error                                     *
+ *******************************************************************************/
+#if ((BOARD_USED_SUM(PORTA_ID) != BOARD_USED_MASK(PORTA_ID)) || (BOARD_USED_SUM(PORTB_ID) != BOARD_USED_MASK(PORTB_ID)) || \
+	 (BOARD_USED_SUM(PORTC_ID) != BOARD_USED_MASK(PORTC_ID)) || (BOARD_USED_SUM(PORTD_ID) != BOARD_USED_MASK(PORTD_ID)))
+#error "A pin is assigned to more than one function in board.h"
+#endif
+
+#if ((BOARD_USED_MASK(PORTA_ID) | BOARD_USED_MASK(PORTB_ID) | BOARD_USED_MASK(PORTC_ID) | BOARD_USED_MASK(PORTD_ID)) > 0xFF)
+#error "A pin number in board.h is out of range"
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to set the boot direction and level of every pin of the board.
+ * The PORT register is written before the DDR register, so an output pin starts at its level.
+ */
+void Board_init(void)
+{
+	PORTA=BOARD_PORT_VALUE(PORTA_ID);
+	DDRA=BOARD_DDR_VALUE(PORTA_ID);
+	PORTB=BOARD_PORT_VALUE(PORTB_ID);
+	DDRB=BOARD_DDR_VALUE(PORTB_ID);
+	PORTC=BOARD_PORT_VALUE(PORTC_ID);
+	DDRC=BOARD_DDR_VALUE(PORTC_ID);
+	PORTD=BOARD_PORT_VALUE(PORTD_ID);
+	DDRD=BOARD_DDR_VALUE(PORTD_ID);
+}
@@ -0,0 +1,106 @@
+/******************************************************************************
+ *
+ * Module: Board
+ *
+ * File Name: board.h
+ *
+ * Description: Pin assignments of the HMI ECU board
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef BOARD_H_
+#define BOARD_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+#include "gpio.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*
+ * Every pin used on the board is assigned here, the drivers take their pins from this file.
+ * The boot direction and level of each pin are listed in the board table in board.c.
+ */
+
+/* LCD Data bits mode configuration, its value should be 4 or 8*/
+#define LCD_DATA_BITS_MODE 8
+
+/*
+ * LCD RW pin configuration, its value should be TRUE if the RW pin is connected to the MCU or
+ * FALSE if it's tied to the ground.
+ * If it's connected the busy flag is polled before every write, otherwise every write is followed
+ * by a delay that covers the longest execution time of the instruction.
+ */
+#define LCD_RW_CONNECTED               TRUE
+
+/* LCD HW Ports and Pins Ids */
+#define LCD_RS_PORT_ID                 PORTB_ID
+#define LCD_RS_PIN_ID                  PIN0_ID
+
+#if (LCD_RW_CONNECTED == TRUE)
+
+#define LCD_RW_PORT_ID                 PORTB_ID
+#define LCD_RW_PIN_ID                  PIN1_ID
+
+#endif
+
+#define LCD_E_PORT_ID                  PORTB_ID
+#define LCD_E_PIN_ID                   PIN2_ID
+
+#define LCD_DATA_PORT_ID               PORTC_ID
+
+#if (LCD_DATA_BITS_MODE == 4)
+
+#define LCD_DB4_PIN_ID                 PIN3_ID
+#define LCD_DB5_PIN_ID                 PIN4_ID
+#define LCD_DB6_PIN_ID                 PIN5_ID
+#define LCD_DB7_PIN_ID                 PIN6_ID
+
+#endif
+
+/* Keypad configurations for number of rows and columns */
+#define KEYPAD_NUM_COLS                   4
+#define KEYPAD_NUM_ROWS                   4
+
+/* Keypad Port Configurations, the rows and the columns are contiguous from their first pin */
+#define KEYPAD_ROW_PORT_ID                PORTA_ID
+#define KEYPAD_FIRST_ROW_PIN_ID           PIN0_ID
+
+#define KEYPAD_COL_PORT_ID                PORTA_ID
+#define KEYPAD_FIRST_COL_PIN_ID           PIN4_ID
+
+/*
+ * Keypad wake up interrupt configurations.
+ * The columns are combined by an AND gate into the INT0 pin, while waiting for a key all
+ * the rows are driven active so any pressed button pulls the gate output low.
+ */
+#define KEYPAD_INT_PORT_ID                PORTD_ID
+#define KEYPAD_INT_PIN_ID                 PIN2_ID
+
+/* Pins fixed by the MCU peripherals, listed to catch any other use of them */
+#define UART_RXD_PORT_ID                  PORTD_ID
+#define UART_RXD_PIN_ID                   PIN0_ID
+#define UART_TXD_PORT_ID                  PORTD_ID
+#define UART_TXD_PIN_ID                   PIN1_ID
+
+#if ((KEYPAD_INT_PORT_ID != PORTD_ID) || (KEYPAD_INT_PIN_ID != PIN2_ID))
+#error "The keypad wake up gate should be connected to the INT0 pin"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to set the boot direction and level of every pin of the board.
+ * The values are computed at compile time, each port costs one PORT store and one DDR store.
+ * It should be called first at boot, the drivers init functions don't configure their pins.
+ */
+void Board_init(void);
+
+#endif /* BOARD_H_ */
@@ -0,0 +1,229 @@
+/******************************************************************************
+ *
+ * Module: External Interrupts
+ *
+ * File Name: exti.c
+ *
+ * Description: Source file for the AVR external interrupts INT0, INT1 and INT2 driver
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "exti.h"
+#include "sys_timer.h" /*To wake the main context from SysTimer_idle*/
+#include "common_macros.h" /*To use macros like SET_BIT*/
+#include <avr/io.h> /*To use the external interrupts registers*/
+#include <avr/interrupt.h> /*For the INT0, INT1 and INT2 ISRs*/
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Call back and context of each line*/
+static Exti_CallBackType volatile g_extiCallBack[EXTI_NUM_OF_LINES]={NULL_PTR,NULL_PTR,NULL_PTR};
+static void * volatile g_extiContext[EXTI_NUM_OF_LINES]={NULL_PTR,NULL_PTR,NULL_PTR};
+
+/*Bit n is set if line n is deferred to the main context*/
+static uint8 g_extiDeferred=0;
+
+/*Bit n is set if the deferred line n triggered and its call back didn't run yet*/
+static volatile uint8 g_extiPending=0;
+
+/*Bits of each line in GICR and GIFR*/
+static const uint8 g_extiEnableBit[EXTI_NUM_OF_LINES]={INT0,INT1,INT2};
+static const uint8 g_extiFlagBit[EXTI_NUM_OF_LINES]={INTF0,INTF1,INTF2};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Common body of the three ISRs, it runs the call back or marks the line pending, then wakes the main context.
+ */
+static inline void Exti_dispatch(Exti_Line line);
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(INT0_vect)
+{
+	Exti_dispatch(EXTI_INT0);
+}
+
+ISR(INT1_vect)
+{
+	Exti_dispatch(EXTI_INT1);
+}
+
+ISR(INT2_vect)
+{
+	Exti_dispatch(EXTI_INT2);
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to set the trigger, the dispatch mode and the call back of a line.
+ * The line is left disabled, it starts with Exti_enable.
+ */
+void Exti_init(Exti_Line line,Exti_Sense sense,Exti_Dispatch dispatch,Exti_CallBackType a_ptr,void *context)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value;
+
+	if(line>=EXTI_NUM_OF_LINES)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+
+		/*The line is disabled while its trigger changes, a change of the trigger may latch a false edge*/
+		CLEAR_BIT(GICR,g_extiEnableBit[line]);
+		switch(line)
+		{
+		case EXTI_INT0:
+			MCUCR=(MCUCR&~((1<<ISC01)|(1<<ISC00)))|(sense<<ISC00);
+			break;
+		case EXTI_INT1:
+			MCUCR=(MCUCR&~((1<<ISC11)|(1<<ISC10)))|(sense<<ISC10);
+			break;
+		default:
+			/*INT2 has one sense bit, cleared for the falling edge and set for the rising edge*/
+			if(sense==EXTI_RISING_EDGE)
+			{
+				SET_BIT(MCUCSR,ISC2);
+			}
+			else
+			{
+				CLEAR_BIT(MCUCSR,ISC2);
+			}
+			break;
+		}
+
+		g_extiCallBack[line]=a_ptr;
+		g_extiContext[line]=context;
+		if(dispatch==EXTI_DISPATCH_DEFERRED)
+		{
+			g_extiDeferred|=(1<<line);
+		}
+		else
+		{
+			g_extiDeferred&=~(1<<line);
+		}
+		g_extiPending&=~(1<<line);
+
+		SREG=sreg_value;
+	}
+}
+
+/*
+ * Description :
+ * Function to enable a line, an edge latched while it was disabled is discarded.
+ */
+void Exti_enable(Exti_Line line)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value;
+
+	if(line>=EXTI_NUM_OF_LINES)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+
+		/*Flags are cleared by writing one, so only the flag of this line is written*/
+		GIFR=(1<<g_extiFlagBit[line]);
+		SET_BIT(GICR,g_extiEnableBit[line]);
+		SREG=sreg_value;
+	}
+}
+
+/*
+ * Description :
+ * Function to disable a line, it's safe to call from the line call back.
+ */
+void Exti_disable(Exti_Line line)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value;
+
+	if(line>=EXTI_NUM_OF_LINES)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+		CLEAR_BIT(GICR,g_extiEnableBit[line]);
+		SREG=sreg_value;
+	}
+}
+
+/*
+ * Description :
+ * Function to run the call backs of the deferred lines triggered since the previous call.
+ * It should be called from the main loop, each pending line runs once however many times it triggered.
+ * Returns TRUE if any call back ran.
+ */
+boolean Exti_processDeferred(void)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the read*/
+	uint8 sreg_value;
+	uint8 pending;
+	uint8 line;
+
+	/*Take all the pending lines at once, a line triggering again meanwhile is kept for the next call*/
+	sreg_value=SREG;
+	SREG&=~(1<<7);
+	pending=g_extiPending;
+	g_extiPending=0;
+	SREG=sreg_value;
+
+	for(line=0;line<EXTI_NUM_OF_LINES;line++)
+	{
+		if((pending&(1<<line)) && (g_extiCallBack[line]!=NULL_PTR))
+		{
+			(*g_extiCallBack[line])(g_extiContext[line]);
+		}
+	}
+
+	return (pending!=0);
+}
+
+/*
+ * Description :
+ * Common body of the three ISRs, it runs the call back or marks the line pending, then wakes the main context.
+ * It's inlined in each ISR with a constant line, so the dispatch costs a few instructions.
+ */
+static inline void Exti_dispatch(Exti_Line line)
+{
+	if(g_extiDeferred&(1<<line))
+	{
+		g_extiPending|=(1<<line);
+	}
+	else if(g_extiCallBack[line]!=NULL_PTR)
+	{
+		(*g_extiCallBack[line])(g_extiContext[line]);
+	}
+	else
+	{
+		/*Do Nothing*/
+	}
+
+	/*
+	 * The main context may be about to sleep after checking for work, so it's woken explicitly.
+	 * A call back run here may post work too, like a deferred line does.
+	 */
+	SysTimer_notify();
+}
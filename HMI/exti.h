@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ * Module: External Interrupts
+ *
+ * File Name: exti.h
+ *
+ * Description: Header file for the AVR external interrupts INT0, INT1 and INT2 driver
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef EXTI_H_
+#define EXTI_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*External interrupt lines: INT0 on PD2, INT1 on PD3 and INT2 on PB2*/
+typedef enum{
+	EXTI_INT0,EXTI_INT1,EXTI_INT2,EXTI_NUM_OF_LINES
+}Exti_Line;
+
+/*
+ * Trigger of a line, the values equal the ISCn1:ISCn0 bits of INT0 and INT1.
+ * NOTE: INT2 supports the falling and rising edges only.
+ */
+typedef enum{
+	EXTI_LOW_LEVEL,EXTI_ANY_CHANGE,EXTI_FALLING_EDGE,EXTI_RISING_EDGE
+}Exti_Sense;
+
+/*
+ * Where the call back of a line runs:
+ * EXTI_DISPATCH_ISR      -> directly from the ISR, it should be short.
+ * EXTI_DISPATCH_DEFERRED -> from Exti_processDeferred in the main context, the ISR only marks the line pending.
+ */
+typedef enum{
+	EXTI_DISPATCH_ISR,EXTI_DISPATCH_DEFERRED
+}Exti_Dispatch;
+
+/*Line call back, it receives the context registered with it*/
+typedef void (*Exti_CallBackType)(void *context);
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to set the trigger, the dispatch mode and the call back of a line.
+ * The line is left disabled, it starts with Exti_enable.
+ */
+void Exti_init(Exti_Line line,Exti_Sense sense,Exti_Dispatch dispatch,Exti_CallBackType a_ptr,void *context);
+
+/*
+ * Description :
+ * Function to enable a line, an edge latched while it was disabled is discarded.
+ */
+void Exti_enable(Exti_Line line);
+
+/*
+ * Description :
+ * Function to disable a line, it's safe to call from the line call back.
+ */
+void Exti_disable(Exti_Line line);
+
+/*
+ * Description :
+ * Function to run the call backs of the deferred lines triggered since the previous call.
+ * It should be called from the main loop, each pending line runs once however many times it triggered.
+ * Returns TRUE if any call back ran.
+ */
+boolean Exti_processDeferred(void);
+
+#endif /* EXTI_H_ */
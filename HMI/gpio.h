@@ -1,102 +1,194 @@
- /******************************************************************************
- *
- * Module: GPIO
- *
- * File Name: gpio.h
- *
- * Description: Header file for the AVR GPIO driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-#ifndef GPIO_H_
-#define GPIO_H_
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-#define NUM_OF_PORTS           4
-#define NUM_OF_PINS_PER_PORT   8
-
-#define PORTA_ID               0
-#define PORTB_ID               1
-#define PORTC_ID               2
-#define PORTD_ID               3
-
-#define PIN0_ID                0
-#define PIN1_ID                1
-#define PIN2_ID                2
-#define PIN3_ID                3
-#define PIN4_ID                4
-#define PIN5_ID                5
-#define PIN6_ID                6
-#define PIN7_ID                7
-
-/*******************************************************************************
- *                               Types Declaration                             *
- *******************************************************************************/
-typedef enum
-{
-	PIN_INPUT,PIN_OUTPUT
-}GPIO_PinDirectionType;
-
-typedef enum
-{
-	PORT_INPUT,PORT_OUTPUT=0xFF
-}GPIO_PortDirectionType;
-
-/*******************************************************************************
- *                              Functions Prototypes                           *
- *******************************************************************************/
-
-/*
- * Description :
- * Setup the direction of the required pin input/output.
- * If the input port number or pin number are not correct, The function will not handle the request.
- */
-void GPIO_setupPinDirection(uint8 port_num, uint8 pin_num, GPIO_PinDirectionType direction);
-
-/*
- * Description :
- * Write the value Logic High or Logic Low on the required pin.
- * If the input port number or pin number are not correct, The function will not handle the request.
- * If the pin is input, this function will enable/disable the internal pull-up resistor.
- */
-void GPIO_writePin(uint8 port_num, uint8 pin_num, uint8 value);
-
-/*
- * Description :
- * Read and return the value for the required pin, it should be Logic High or Logic Low.
- * If the input port number or pin number are not correct, The function will return Logic Low.
- */
-uint8 GPIO_readPin(uint8 port_num, uint8 pin_num);
-
-/*
- * Description :
- * Setup the direction of the required port all pins input/output.
- * If the direction value is PORT_INPUT all pins in this port should be input pins.
- * If the direction value is PORT_OUTPUT all pins in this port should be output pins.
- * If the input port number is not correct, The function will not handle the request.
- */
-void GPIO_setupPortDirection(uint8 port_num, GPIO_PortDirectionType direction);
-
-/*
- * Description :
- * Write the value on the required port.
- * If any pin in the port is output pin the value will be written.
- * If any pin in the port is input pin this will activate/deactivate the internal pull-up resistor.
- * If the input port number is not correct, The function will not handle the request.
- */
-void GPIO_writePort(uint8 port_num, uint8 value);
-
-/*
- * Description :
- * Read and return the value of the required port.
- * If the input port number is not correct, The function will return ZERO value.
- */
-uint8 GPIO_readPort(uint8 port_num);
-
-#endif /* GPIO_H_ */
+ /******************************************************************************
+ *
+ * Module: GPIO
+ *
+ * File Name: gpio.h
+ *
+ * Description: Header file for the AVR GPIO driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+#ifndef GPIO_H_
+#define GPIO_H_
+
+#include "std_types.h"
+#include "common_macros.h" /* To use the macros like SET_BIT */
+#include <avr/io.h> /* To use the IO Ports Registers */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define NUM_OF_PORTS           4
+#define NUM_OF_PINS_PER_PORT   8
+
+#define PORTA_ID               0
+#define PORTB_ID               1
+#define PORTC_ID               2
+#define PORTD_ID               3
+
+#define PIN0_ID                0
+#define PIN1_ID                1
+#define PIN2_ID                2
+#define PIN3_ID                3
+#define PIN4_ID                4
+#define PIN5_ID                5
+#define PIN6_ID                6
+#define PIN7_ID                7
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum
+{
+	PIN_INPUT,PIN_OUTPUT
+}GPIO_PinDirectionType;
+
+typedef enum
+{
+	PORT_INPUT,PORT_OUTPUT=0xFF
+}GPIO_PortDirectionType;
+
+/*******************************************************************************
+ *                           Constant Pin Access                               *
+ *******************************************************************************/
+
+/*
+ * The port and pin of a pin driven by a driver are always constants from its header file, for these
+ * pins the macros below replace the functions of this driver. The register is selected at compile time
+ * and no check is done at run time, so each access is a single access of the register. With the
+ * constant arguments avr-gcc is expected to emit one sbi, cbi or sbis/sbic for it, this is not
+ * checked by the host tests.
+ * A port or pin number out of range, or one that isn't a constant, is a build error instead of an
+ * ignored request. The functions remain for the port and pin numbers only known at run time.
+ */
+
+/* Fails to compile if the port number isn't a constant or isn't correct */
+#define GPIO_CHECK_PORT(port_num) \
+	((void)sizeof(struct{ _Static_assert((port_num) < NUM_OF_PORTS, "GPIO port number out of range"); char c; }))
+
+/* Fails to compile if the port number or pin number aren't constants or aren't correct */
+#define GPIO_CHECK_PIN(port_num,pin_num) \
+	((void)sizeof(struct{ _Static_assert(((port_num) < NUM_OF_PORTS) && ((pin_num) < NUM_OF_PINS_PER_PORT), \
+	"GPIO port or pin number out of range"); char c; }))
+
+/* Register of the required port, the port number is checked like the pin macros */
+#define GPIO_PORT_REG(port_num)  (*(GPIO_CHECK_PORT(port_num), ((port_num) == PORTA_ID) ? &PORTA : \
+                                    ((port_num) == PORTB_ID) ? &PORTB : ((port_num) == PORTC_ID) ? &PORTC : &PORTD))
+#define GPIO_DDR_REG(port_num)   (*(GPIO_CHECK_PORT(port_num), ((port_num) == PORTA_ID) ? &DDRA : \
+                                    ((port_num) == PORTB_ID) ? &DDRB : ((port_num) == PORTC_ID) ? &DDRC : &DDRD))
+#define GPIO_PIN_REG(port_num)   (*(GPIO_CHECK_PORT(port_num), ((port_num) == PORTA_ID) ? &PINA : \
+                                    ((port_num) == PORTB_ID) ? &PINB : ((port_num) == PORTC_ID) ? &PINC : &PIND))
+
+/* Setup the direction of the required pin input/output, like GPIO_setupPinDirection */
+#define GPIO_SETUP_PIN_DIRECTION(port_num,pin_num,direction) \
+	do{ \
+		GPIO_CHECK_PIN(port_num,pin_num); \
+		if((direction) == PIN_OUTPUT){ SET_BIT(GPIO_DDR_REG(port_num),(pin_num)); } \
+		else{ CLEAR_BIT(GPIO_DDR_REG(port_num),(pin_num)); } \
+	}while(0)
+
+/* Write the value Logic High or Logic Low on the required pin, like GPIO_writePin */
+#define GPIO_WRITE_PIN(port_num,pin_num,value) \
+	do{ \
+		GPIO_CHECK_PIN(port_num,pin_num); \
+		if((value) == LOGIC_HIGH){ SET_BIT(GPIO_PORT_REG(port_num),(pin_num)); } \
+		else{ CLEAR_BIT(GPIO_PORT_REG(port_num),(pin_num)); } \
+	}while(0)
+
+/* Write the value bits of the mask on the required port in one atomic write, like GPIO_writeMasked */
+#define GPIO_WRITE_MASKED(port_num,mask,value) \
+	do{ \
+		uint8 gpio_sreg_value; \
+		GPIO_CHECK_PORT(port_num); \
+		gpio_sreg_value = SREG; \
+		SREG &= ~(1<<7); \
+		GPIO_PORT_REG(port_num) = (GPIO_PORT_REG(port_num) & (uint8)~(mask)) | ((value) & (mask)); \
+		SREG = gpio_sreg_value; \
+	}while(0)
+
+/* Setup the direction of the mask pins in one atomic write, like GPIO_configureMasked */
+#define GPIO_CONFIGURE_MASKED(port_num,mask,direction) \
+	do{ \
+		uint8 gpio_sreg_value; \
+		GPIO_CHECK_PORT(port_num); \
+		gpio_sreg_value = SREG; \
+		SREG &= ~(1<<7); \
+		GPIO_DDR_REG(port_num) = (GPIO_DDR_REG(port_num) & (uint8)~(mask)) | ((direction) & (mask)); \
+		SREG = gpio_sreg_value; \
+	}while(0)
+
+/* Read and return the value for the required pin, Logic High or Logic Low, like GPIO_readPin */
+#define GPIO_READ_PIN(port_num,pin_num) \
+	(GPIO_CHECK_PIN(port_num,pin_num), (BIT_IS_SET(GPIO_PIN_REG(port_num),(pin_num)) ? LOGIC_HIGH : LOGIC_LOW))
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the direction of the required pin input/output.
+ * If the input port number or pin number are not correct, The function will not handle the request.
+ */
+void GPIO_setupPinDirection(uint8 port_num, uint8 pin_num, GPIO_PinDirectionType direction);
+
+/*
+ * Description :
+ * Write the value Logic High or Logic Low on the required pin.
+ * If the input port number or pin number are not correct, The function will not handle the request.
+ * If the pin is input, this function will enable/disable the internal pull-up resistor.
+ */
+void GPIO_writePin(uint8 port_num, uint8 pin_num, uint8 value);
+
+/*
+ * Description :
+ * Read and return the value for the required pin, it should be Logic High or Logic Low.
+ * If the input port number or pin number are not correct, The function will return Logic Low.
+ */
+uint8 GPIO_readPin(uint8 port_num, uint8 pin_num);
+
+/*
+ * Description :
+ * Write the bits of the value selected by the mask on the required port, the other pins keep their values.
+ * All the pins change together in one register write, and the read-modify-write is done with the
+ * interrupts disabled so an ISR writing the same port can't be overwritten.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value);
+
+/*
+ * Description :
+ * Setup the direction of the pins selected by the mask in one atomic register write.
+ * A set bit of the direction makes its pin an output pin, a cleared bit makes it an input pin.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_configureMasked(uint8 port_num, uint8 mask, uint8 direction);
+
+/*
+ * Description :
+ * Setup the direction of the required port all pins input/output.
+ * If the direction value is PORT_INPUT all pins in this port should be input pins.
+ * If the direction value is PORT_OUTPUT all pins in this port should be output pins.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_setupPortDirection(uint8 port_num, GPIO_PortDirectionType direction);
+
+/*
+ * Description :
+ * Write the value on the required port.
+ * If any pin in the port is output pin the value will be written.
+ * If any pin in the port is input pin this will activate/deactivate the internal pull-up resistor.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writePort(uint8 port_num, uint8 value);
+
+/*
+ * Description :
+ * Read and return the value of the required port.
+ * If the input port number is not correct, The function will return ZERO value.
+ */
+uint8 GPIO_readPort(uint8 port_num);
+
+#endif /* GPIO_H_ */
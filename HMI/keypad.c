@@ -1,170 +1,349 @@
- /******************************************************************************
- *
- * Module: KEYPAD
- *
- * File Name: keypad.c
- *
- * Description: Source file for the Keypad driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-#include "keypad.h"
-#include "gpio.h"
-#include <util/delay.h>
-
-/*******************************************************************************
- *                      Functions Prototypes(Private)                          *
- *******************************************************************************/
-
-#ifndef STANDARD_KEYPAD
-
-#if (KEYPAD_NUM_COLS == 3)
-/*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x3 keypad
- */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
-#elif (KEYPAD_NUM_COLS == 4)
-/*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x4 keypad
- */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
-#endif
-
-#endif /* STANDARD_KEYPAD */
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-
-uint8 KEYPAD_getPressedKey(void)
-{
-	uint8 col,row;
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_INPUT);
-
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_INPUT);
-#if(KEYPAD_NUM_COLS == 4)
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_INPUT);
-#endif
-	while(1)
-	{
-		for(row=0 ; row<KEYPAD_NUM_ROWS ; row++) /* loop for rows */
-		{
-			/* 
-			 * Each time setup the direction for all keypad port as input pins,
-			 * except this row will be output pin
-			 */
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
-
-			/* Set/Clear the row output pin */
-			GPIO_writePin(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
-
-			for(col=0 ; col<KEYPAD_NUM_COLS ; col++) /* loop for columns */
-			{
-				/* Check if the switch is pressed in this column */
-				if(GPIO_readPin(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
-				{
-					#if (KEYPAD_NUM_COLS == 3)
-						#ifdef STANDARD_KEYPAD
-							return ((row*KEYPAD_NUM_COLS)+col+1);
-						#else
-							return KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-						#endif
-					#elif (KEYPAD_NUM_COLS == 4)
-						#ifdef STANDARD_KEYPAD
-							return ((row*KEYPAD_NUM_COLS)+col+1);
-						#else
-							return KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-						#endif
-					#endif
-				}
-			}
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
-			_delay_ms(5); /* Add small delay to fix CPU load issue in proteus */
-		}
-	}	
-}
-
-#ifndef STANDARD_KEYPAD
-
-#if (KEYPAD_NUM_COLS == 3)
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x3 shape
- */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
-{
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 10: keypad_button = '*'; // ASCII Code of *
-				 break;
-		case 11: keypad_button = 0;
-				 break;		
-		case 12: keypad_button = '#'; // ASCII Code of #
-				 break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-} 
-
-#elif (KEYPAD_NUM_COLS == 4)
-
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x4 shape
- */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
-{
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 1: keypad_button = 7;
-				break;
-		case 2: keypad_button = 8;
-				break;
-		case 3: keypad_button = 9;
-				break;
-		case 4: keypad_button = '%'; // ASCII Code of %
-				break;
-		case 5: keypad_button = 4;
-				break;
-		case 6: keypad_button = 5;
-				break;
-		case 7: keypad_button = 6;
-				break;
-		case 8: keypad_button = '*'; /* ASCII Code of '*' */
-				break;		
-		case 9: keypad_button = 1;
-				break;
-		case 10: keypad_button = 2;
-				break;
-		case 11: keypad_button = 3;
-				break;
-		case 12: keypad_button = '-'; /* ASCII Code of '-' */
-				break;
-		case 13: keypad_button = 13;  /* ASCII of Enter */
-				break;			
-		case 14: keypad_button = 0;
-				break;
-		case 15: keypad_button = '='; /* ASCII Code of '=' */
-				break;
-		case 16: keypad_button = '+'; /* ASCII Code of '+' */
-				break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-} 
-
-#endif
-
-#endif /* STANDARD_KEYPAD */
+ /******************************************************************************
+ *
+ * Module: KEYPAD
+ *
+ * File Name: keypad.c
+ *
+ * Description: Source file for the Keypad driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+#include "keypad.h"
+#include "gpio.h"
+#include "sys_timer.h"
+#include "exti.h"
+#include <avr/io.h> /* To use the SREG register */
+#include <avr/pgmspace.h> /* To keep the keymap in the flash */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define KEYPAD_NUM_BUTTONS                (KEYPAD_NUM_ROWS*KEYPAD_NUM_COLS)
+
+/* Mask of the columns after shifting the port value to the first column */
+#define KEYPAD_COLS_MASK                  ((1<<KEYPAD_NUM_COLS)-1)
+
+/* Mask of the rows in the row port */
+#define KEYPAD_ROWS_MASK                  (((1<<KEYPAD_NUM_ROWS)-1)<<KEYPAD_FIRST_ROW_PIN_ID)
+
+/* Repeat times in scanner periods */
+#define KEYPAD_REPEAT_DELAY_SCANS         (KEYPAD_REPEAT_DELAY_MS/KEYPAD_SCAN_PERIOD_MS)
+#define KEYPAD_REPEAT_PERIOD_SCANS        (KEYPAD_REPEAT_PERIOD_MS/KEYPAD_SCAN_PERIOD_MS)
+
+/* Index of the repeating button when no button is held */
+#define KEYPAD_NO_BUTTON                  0xFF
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/*
+ * Value of each button indexed by (row*KEYPAD_NUM_COLS)+col, it's laid out like the keypad itself
+ * so a new keypad shape only needs a new table.
+ */
+static const uint8 g_keypadKeymap[KEYPAD_NUM_BUTTONS] PROGMEM = {
+#ifdef STANDARD_KEYPAD
+	1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,
+#if (KEYPAD_NUM_COLS == 4)
+	13,  14,  15,  16
+#endif
+#elif (KEYPAD_NUM_COLS == 3)
+	1,   2,   3,
+	4,   5,   6,
+	7,   8,   9,
+	'*', 0,   '#'
+#elif (KEYPAD_NUM_COLS == 4)
+	7,   8,   9,   '%',
+	4,   5,   6,   '*',
+	1,   2,   3,   '-',
+	13,  0,   '=', '+'   /* 13 is the ASCII of Enter */
+#endif
+};
+
+/*
+ * Debounce integrator of each button, it counts up while the button reads pressed and down while it
+ * reads released. The debounced state only changes when the integrator reaches one of its limits.
+ */
+static uint8 g_keypadIntegrator[KEYPAD_NUM_BUTTONS];
+
+/* Debounced state of the buttons, bit n is set while button n is pressed */
+static uint16 g_keypadState = 0;
+
+/* Last pressed button and the scans left until its next repeat event */
+static uint8 g_keypadRepeatButton = KEYPAD_NO_BUTTON;
+static uint8 g_keypadRepeatScans;
+
+/* Key events queue, written by the scanner in the ISR and read by the main context */
+static volatile KEYPAD_EventType g_keypadQueue[KEYPAD_EVENT_QUEUE_SIZE];
+static volatile uint8 g_keypadQueueHead = 0;
+static volatile uint8 g_keypadQueueTail = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for scanning all the keypad rows once.
+ * Returns the raw state of the buttons, bit n is set if button n reads pressed.
+ */
+static uint16 KEYPAD_scan(void);
+
+/*
+ * Function responsible for driving all the rows active and arming the INT0 interrupt.
+ */
+static void KEYPAD_armInterrupt(void);
+
+/*
+ * Function responsible for adding an event to the queue, the event is dropped if the queue is full.
+ */
+static void KEYPAD_pushEvent(uint8 button,KEYPAD_EventKind kind);
+
+/*
+ * Call back function of the scanner system timer, it debounces the buttons and queues their events.
+ */
+static void KEYPAD_scanCallBack(void *context);
+
+/*
+ * Call back function of the INT0 line, it starts the scanner on a key press.
+ */
+static void KEYPAD_wakeCallBack(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the INT0 falling edge interrupt used to start the scanner on a key press.
+ * The keypad pins directions are set by Board_init.
+ */
+void KEYPAD_init(void)
+{
+	uint8 button;
+
+	for(button=0 ; button<KEYPAD_NUM_BUTTONS ; button++)
+	{
+		g_keypadIntegrator[button] = 0;
+	}
+
+	/* INT0 is triggered by the falling edge of the columns gate output, the scanner is started from the ISR */
+	Exti_init(EXTI_INT0, EXTI_FALLING_EDGE, EXTI_DISPATCH_ISR, KEYPAD_wakeCallBack, NULL_PTR);
+
+	KEYPAD_armInterrupt();
+}
+
+/*
+ * Description :
+ * Get the next key event without waiting.
+ * Returns TRUE and fills the event if one is queued, FALSE if the queue is empty.
+ */
+boolean KEYPAD_getEvent(KEYPAD_EventType *event)
+{
+	/* Variable to store the SREG value, to restore the I-bit after the read */
+	uint8 sreg_value;
+	boolean found = FALSE;
+
+	sreg_value = SREG;
+	SREG &= ~(1<<7);
+	if(g_keypadQueueHead != g_keypadQueueTail)
+	{
+		event->key = g_keypadQueue[g_keypadQueueTail].key;
+		event->kind = g_keypadQueue[g_keypadQueueTail].kind;
+		g_keypadQueueTail = (g_keypadQueueTail+1) & (KEYPAD_EVENT_QUEUE_SIZE-1);
+		found = TRUE;
+	}
+	SREG = sreg_value;
+
+	return found;
+}
+
+/*
+ * Description :
+ * Discard all the queued key events, the keys typed ahead are dropped.
+ */
+void KEYPAD_flush(void)
+{
+	/* Only the reader moves the tail, so a single write empties the queue */
+	g_keypadQueueTail = g_keypadQueueHead;
+}
+
+uint8 KEYPAD_getPressedKey(void)
+{
+	KEYPAD_EventType event;
+
+	do
+	{
+		/* The scanner runs in a system timer call back, so SysTimer_idle can't sleep over a new event */
+		while(KEYPAD_getEvent(&event) == FALSE)
+		{
+			SysTimer_idle();
+		}
+	}while(event.kind != KEYPAD_PRESS);
+
+	return event.key;
+}
+
+/*
+ * Description :
+ * Scan all the keypad rows once, only the scanned row is driven while the others are left floating
+ * so two buttons pressed in the same column never short two driven rows.
+ */
+static uint16 KEYPAD_scan(void)
+{
+	uint8 row,cols;
+	uint16 raw = 0;
+
+	for(row=0 ; row<KEYPAD_NUM_ROWS ; row++) /* loop for rows */
+	{
+		/* Only this row will be output pin, its port bit is already at the pressed level */
+		GPIO_CONFIGURE_MASKED(KEYPAD_ROW_PORT_ID,KEYPAD_ROWS_MASK,(1<<(KEYPAD_FIRST_ROW_PIN_ID+row)));
+
+		/* The pin value passes through a synchronizer, so wait one cycle before reading the new level */
+		__asm__ __volatile__ ("nop");
+
+		/* Read all the columns at once */
+		cols = (GPIO_PIN_REG(KEYPAD_COL_PORT_ID) >> KEYPAD_FIRST_COL_PIN_ID) & KEYPAD_COLS_MASK;
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+		cols = (~cols) & KEYPAD_COLS_MASK;
+#endif
+		raw |= ((uint16)cols << (row*KEYPAD_NUM_COLS));
+	}
+	GPIO_CONFIGURE_MASKED(KEYPAD_ROW_PORT_ID,KEYPAD_ROWS_MASK,0);
+
+	return raw;
+}
+
+/*
+ * Description :
+ * Drive all the rows active so any pressed button pulls its column low, then arm INT0.
+ */
+static void KEYPAD_armInterrupt(void)
+{
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+	GPIO_WRITE_MASKED(KEYPAD_ROW_PORT_ID,KEYPAD_ROWS_MASK,0);
+#else
+	GPIO_WRITE_MASKED(KEYPAD_ROW_PORT_ID,KEYPAD_ROWS_MASK,KEYPAD_ROWS_MASK);
+#endif
+	GPIO_CONFIGURE_MASKED(KEYPAD_ROW_PORT_ID,KEYPAD_ROWS_MASK,KEYPAD_ROWS_MASK);
+
+	/* A stale edge from the scan is discarded, it shouldn't restart the scanner */
+	Exti_enable(EXTI_INT0);
+}
+
+/*
+ * Description :
+ * Add an event to the queue, it's called from the ISR only.
+ * The event is dropped if the queue is full, as the queued events are older than it.
+ */
+static void KEYPAD_pushEvent(uint8 button,KEYPAD_EventKind kind)
+{
+	uint8 next = (g_keypadQueueHead+1) & (KEYPAD_EVENT_QUEUE_SIZE-1);
+
+	if(next == g_keypadQueueTail)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		g_keypadQueue[g_keypadQueueHead].key = pgm_read_byte(&g_keypadKeymap[button]);
+		g_keypadQueue[g_keypadQueueHead].kind = kind;
+		g_keypadQueueHead = next;
+	}
+}
+
+/*
+ * Description :
+ * Call back function of the scanner system timer, it debounces the buttons and queues their events.
+ * Once all the buttons are released and settled the scanner stops and INT0 is armed again,
+ * so no scan runs at all while the keypad is idle.
+ */
+static void KEYPAD_scanCallBack(void *context)
+{
+	uint8 button;
+	uint16 raw = KEYPAD_scan();
+	uint16 mask;
+	boolean settled = TRUE;
+
+	for(button=0,mask=1 ; button<KEYPAD_NUM_BUTTONS ; button++,mask<<=1)
+	{
+		if(raw & mask)
+		{
+			if(g_keypadIntegrator[button] < KEYPAD_DEBOUNCE_SAMPLES)
+			{
+				g_keypadIntegrator[button]++;
+			}
+			if((g_keypadIntegrator[button] == KEYPAD_DEBOUNCE_SAMPLES) && ((g_keypadState & mask) == 0))
+			{
+				g_keypadState |= mask;
+				g_keypadRepeatButton = button;
+				/* The count down starts in this same scan, one more scan makes the full delay */
+				g_keypadRepeatScans = KEYPAD_REPEAT_DELAY_SCANS+1;
+				KEYPAD_pushEvent(button,KEYPAD_PRESS);
+			}
+		}
+		else
+		{
+			if(g_keypadIntegrator[button] > 0)
+			{
+				g_keypadIntegrator[button]--;
+			}
+			if((g_keypadIntegrator[button] == 0) && (g_keypadState & mask))
+			{
+				g_keypadState &= ~mask;
+				if(g_keypadRepeatButton == button)
+				{
+					g_keypadRepeatButton = KEYPAD_NO_BUTTON;
+				}
+				KEYPAD_pushEvent(button,KEYPAD_RELEASE);
+			}
+		}
+
+		if(g_keypadIntegrator[button] != 0)
+		{
+			settled = FALSE;
+		}
+	}
+
+	/* Only the last pressed button repeats while it's held */
+	if(g_keypadRepeatButton == KEYPAD_NO_BUTTON)
+	{
+		/* Do Nothing */
+	}
+	else if(--g_keypadRepeatScans == 0)
+	{
+		g_keypadRepeatScans = KEYPAD_REPEAT_PERIOD_SCANS;
+		KEYPAD_pushEvent(g_keypadRepeatButton,KEYPAD_REPEAT);
+	}
+
+	if(settled == FALSE)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		SysTimer_stop(SYS_TIMER_KEYPAD);
+		KEYPAD_armInterrupt();
+
+		/* A press after the last scan leaves the gate low without a new edge, so keep scanning */
+		if(GPIO_READ_PIN(KEYPAD_INT_PORT_ID, KEYPAD_INT_PIN_ID) == KEYPAD_BUTTON_PRESSED)
+		{
+			Exti_disable(EXTI_INT0);
+			SysTimer_start(SYS_TIMER_KEYPAD,SYS_TIMER_MS_TO_TICKS(KEYPAD_SCAN_PERIOD_MS),
+					SYS_TIMER_MS_TO_TICKS(KEYPAD_SCAN_PERIOD_MS),KEYPAD_scanCallBack,NULL_PTR);
+		}
+	}
+}
+
+/*
+ * Description :
+ * Call back function of the INT0 line, it starts the scanner on a key press.
+ * The scanner takes over until all the buttons are released, it also filters the contact bounce.
+ */
+static void KEYPAD_wakeCallBack(void *context)
+{
+	Exti_disable(EXTI_INT0);
+	SysTimer_start(SYS_TIMER_KEYPAD,SYS_TIMER_MS_TO_TICKS(KEYPAD_SCAN_PERIOD_MS),
+			SYS_TIMER_MS_TO_TICKS(KEYPAD_SCAN_PERIOD_MS),KEYPAD_scanCallBack,NULL_PTR);
+}
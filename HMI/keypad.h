@@ -1,47 +1,104 @@
- /******************************************************************************
- *
- * Module: KEYPAD
- *
- * File Name: keypad.h
- *
- * Description: Header file for the Keypad driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-#ifndef KEYPAD_H_
-#define KEYPAD_H_
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-
-/* Keypad configurations for number of rows and columns */
-#define KEYPAD_NUM_COLS                   4
-#define KEYPAD_NUM_ROWS                   4
-
-/* Keypad Port Configurations */
-#define KEYPAD_ROW_PORT_ID                PORTA_ID
-#define KEYPAD_FIRST_ROW_PIN_ID           PIN0_ID
-
-#define KEYPAD_COL_PORT_ID                PORTA_ID
-#define KEYPAD_FIRST_COL_PIN_ID           PIN4_ID
-
-/* Keypad button logic configurations */
-#define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
-#define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description :
- * Get the Keypad pressed button
- */
-uint8 KEYPAD_getPressedKey(void);
-
-#endif /* KEYPAD_H_ */
+ /******************************************************************************
+ *
+ * Module: KEYPAD
+ *
+ * File Name: keypad.h
+ *
+ * Description: Header file for the Keypad driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+#ifndef KEYPAD_H_
+#define KEYPAD_H_
+
+#include "std_types.h"
+#include "board.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The number of rows and columns and the keypad pins are assigned in board.h */
+
+/* Keypad button logic configurations */
+#define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
+#define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
+
+/* Period of the debounce scanner, it only runs while a button is pressed */
+#define KEYPAD_SCAN_PERIOD_MS             10
+
+/* Number of equal consecutive samples needed to accept a press or a release */
+#define KEYPAD_DEBOUNCE_SAMPLES           3
+
+/* Hold time before the first repeat event, then the time between two repeat events */
+#define KEYPAD_REPEAT_DELAY_MS            500
+#define KEYPAD_REPEAT_PERIOD_MS           150
+
+/*
+ * Number of key events kept until they are read, it should be a power of 2.
+ * It's also the type-ahead buffer of the keypad, the keys pressed while the application is busy
+ * wait here. A press and its release take two entries, so 32 entries hold 16 keys.
+ */
+#define KEYPAD_EVENT_QUEUE_SIZE           32
+
+#if((KEYPAD_EVENT_QUEUE_SIZE & (KEYPAD_EVENT_QUEUE_SIZE-1)) != 0)
+
+#error "Keypad event queue size should be a power of 2"
+
+#endif
+
+#if((KEYPAD_DEBOUNCE_SAMPLES < 1) || (KEYPAD_REPEAT_DELAY_MS < KEYPAD_SCAN_PERIOD_MS) || (KEYPAD_REPEAT_PERIOD_MS < KEYPAD_SCAN_PERIOD_MS))
+
+#error "Keypad debounce samples should be at least 1, and the repeat times at least one scan period"
+
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	KEYPAD_PRESS,KEYPAD_RELEASE,KEYPAD_REPEAT
+}KEYPAD_EventKind;
+
+typedef struct
+{
+	uint8 key; /* Mapped value of the button, the same value returned by KEYPAD_getPressedKey */
+	KEYPAD_EventKind kind;
+}KEYPAD_EventType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the INT0 falling edge interrupt used to start the scanner on a key press.
+ * The keypad pins directions are set by Board_init.
+ */
+void KEYPAD_init(void);
+
+/*
+ * Description :
+ * Get the next key event without waiting.
+ * Returns TRUE and fills the event if one is queued, FALSE if the queue is empty.
+ */
+boolean KEYPAD_getEvent(KEYPAD_EventType *event);
+
+/*
+ * Description :
+ * Discard all the queued key events, the keys typed ahead are dropped.
+ */
+void KEYPAD_flush(void);
+
+/*
+ * Description :
+ * Get the Keypad pressed button, the CPU sleeps in the idle mode until a key press event is queued.
+ * Release and repeat events are discarded, so a held button returns once.
+ */
+uint8 KEYPAD_getPressedKey(void);
+
+#endif /* KEYPAD_H_ */
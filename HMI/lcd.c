@@ -1,220 +1,795 @@
- /******************************************************************************
- *
- * Module: LCD
- *
- * File Name: lcd.c
- *
- * Description: Source file for the LCD driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-#include <util/delay.h> /* For the delay functions */
-#include "common_macros.h" /* For GET_BIT Macro */
-#include "lcd.h"
-#include "gpio.h"
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-
-/*
- * Description :
- * Initialize the LCD:
- * 1. Setup the LCD pins directions by use the GPIO driver.
- * 2. Setup the LCD Data Mode 4-bits or 8-bits.
- */
-void LCD_init(void)
-{
-	/* Configure the direction for RS and E pins as output pins */
-	GPIO_setupPinDirection(LCD_RS_PORT_ID,LCD_RS_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_E_PORT_ID,LCD_E_PIN_ID,PIN_OUTPUT);
-
-	_delay_ms(20);		/* LCD Power ON delay always > 15ms */
-
-#if(LCD_DATA_BITS_MODE == 4)
-	/* Configure 4 pins in the data port as output pins */
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,PIN_OUTPUT);
-
-	/* Send for 4 bit initialization of LCD  */
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
-
-	/* use 2-lines LCD + 4-bits Data Mode + 5*7 dot display Mode */
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE);
-
-#elif(LCD_DATA_BITS_MODE == 8)
-	/* Configure the data port as output port */
-	GPIO_setupPortDirection(LCD_DATA_PORT_ID,PORT_OUTPUT);
-
-	/* use 2-lines LCD + 8-bits Data Mode + 5*7 dot display Mode */
-	LCD_sendCommand(LCD_TWO_LINES_EIGHT_BITS_MODE);
-
-#endif
-
-	LCD_sendCommand(LCD_CURSOR_OFF); /* cursor off */
-	LCD_sendCommand(LCD_CLEAR_COMMAND); /* clear LCD at the beginning */
-}
-
-/*
- * Description :
- * Send the required command to the screen
- */
-void LCD_sendCommand(uint8 command)
-{
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-#if(LCD_DATA_BITS_MODE == 4)
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,4));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,5));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,6));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,7));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,0));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,1));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,2));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,3));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-
-#elif(LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID,command); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-#endif
-}
-
-/*
- * Description :
- * Display the required character on the screen
- */
-void LCD_displayCharacter(uint8 data)
-{
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-#if(LCD_DATA_BITS_MODE == 4)
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,4));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,5));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,6));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,7));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,0));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,1));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,2));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,3));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-
-#elif(LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID,data); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-#endif
-}
-
-/*
- * Description :
- * Display the required string on the screen
- */
-void LCD_displayString(const char *Str)
-{
-	uint8 i = 0;
-	while(Str[i] != '\0')
-	{
-		LCD_displayCharacter(Str[i]);
-		i++;
-	}
-	/***************** Another Method ***********************
-	while((*Str) != '\0')
-	{
-		LCD_displayCharacter(*Str);
-		Str++;
-	}		
-	*********************************************************/
-}
-
-/*
- * Description :
- * Move the cursor to a specified row and column index on the screen
- */
-void LCD_moveCursor(uint8 row,uint8 col)
-{
-	uint8 lcd_memory_address;
-	
-	/* Calculate the required address in the LCD DDRAM */
-	switch(row)
-	{
-		case 0:
-			lcd_memory_address=col;
-				break;
-		case 1:
-			lcd_memory_address=col+0x40;
-				break;
-		case 2:
-			lcd_memory_address=col+0x10;
-				break;
-		case 3:
-			lcd_memory_address=col+0x50;
-				break;
-	}					
-	/* Move the LCD cursor to this specific address */
-	LCD_sendCommand(lcd_memory_address | LCD_SET_CURSOR_LOCATION);
-}
-
-/*
- * Description :
- * Display the required string in a specified row and column index on the screen
- */
-void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
-{
-	LCD_moveCursor(row,col); /* go to to the required LCD position */
-	LCD_displayString(Str); /* display the string */
-}
-
-/*
- * Description :
- * Display the required decimal value on the screen
- */
-void LCD_intgerToString(int data)
-{
-   char buff[16]; /* String to hold the ascii result */
-   itoa(data,buff,10); /* Use itoa C function to convert the data to its corresponding ASCII value, 10 for decimal */
-   LCD_displayString(buff); /* Display the string */
-}
-
-/*
- * Description :
- * Send the clear screen command
- */
-void LCD_clearScreen(void)
-{
-	LCD_sendCommand(LCD_CLEAR_COMMAND); /* Send clear display command */
-}
+ /******************************************************************************
+ *
+ * Module: LCD
+ *
+ * File Name: lcd.c
+ *
+ * Description: Source file for the LCD driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+#include <util/delay.h> /* For the delay functions */
+#include "common_macros.h" /* For GET_BIT, SET_BIT and CLEAR_BIT Macros */
+#include "lcd.h"
+#include "gpio.h"
+#include "timer_mgr.h"
+#include <avr/io.h> /* To use the Timer2 registers */
+#include <avr/interrupt.h> /* For the output queue ISR */
+#include <avr/pgmspace.h> /* To read the strings stored in the flash */
+
+#if (TIMER2_OWNER != TIMER_OWNER_LCD)
+#error "Timer2 isn't assigned to the LCD in timer_mgr.h"
+#endif
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/*
+ * The data bus and E pin are written directly to their port registers, the registers are resolved
+ * at compile time from the port ids, so every write is a single read-modify-write of the port.
+ */
+#if (LCD_DATA_PORT_ID == PORTA_ID)
+#define LCD_DATA_PORT_REG              PORTA
+#elif (LCD_DATA_PORT_ID == PORTB_ID)
+#define LCD_DATA_PORT_REG              PORTB
+#elif (LCD_DATA_PORT_ID == PORTC_ID)
+#define LCD_DATA_PORT_REG              PORTC
+#elif (LCD_DATA_PORT_ID == PORTD_ID)
+#define LCD_DATA_PORT_REG              PORTD
+#endif
+
+#if (LCD_E_PORT_ID == PORTA_ID)
+#define LCD_E_PORT_REG                 PORTA
+#elif (LCD_E_PORT_ID == PORTB_ID)
+#define LCD_E_PORT_REG                 PORTB
+#elif (LCD_E_PORT_ID == PORTC_ID)
+#define LCD_E_PORT_REG                 PORTC
+#elif (LCD_E_PORT_ID == PORTD_ID)
+#define LCD_E_PORT_REG                 PORTD
+#endif
+
+/*
+ * Delay between two edges driven by the MCU. Every bus timing (Tas, Tpw, Tddr, Th) is shorter than 250ns,
+ * so up to 4MHz the next output instruction is late enough by itself. It doesn't cover a read of the bus.
+ */
+#if(LCD_F_CPU <= 4000000UL)
+#define LCD_BUS_DELAY()                do{ }while(0)
+#else
+#define LCD_BUS_DELAY()                __builtin_avr_delay_cycles((LCD_F_CPU+3999999UL)/4000000UL)
+#endif
+
+/*
+ * Delay before reading the data pins after E rises. The PIN register sees a pin change 0.5 to 1.5 cycles
+ * late through the input synchronizer, so without it the read may return the level from before E rose.
+ */
+#define LCD_READ_SYNC_DELAY()          __asm__ __volatile__ ("nop")
+
+#if(LCD_DATA_BITS_MODE == 4)
+
+/* Mask of DB4 --> DB7 in the data port */
+#define LCD_DATA_MASK                  ((1<<LCD_DB4_PIN_ID)|(1<<LCD_DB5_PIN_ID)|(1<<LCD_DB6_PIN_ID)|(1<<LCD_DB7_PIN_ID))
+
+#if((LCD_DB5_PIN_ID == LCD_DB4_PIN_ID+1) && (LCD_DB6_PIN_ID == LCD_DB4_PIN_ID+2) && (LCD_DB7_PIN_ID == LCD_DB4_PIN_ID+3))
+/* The data pins are contiguous, the nibble is moved to its place with one shift */
+#define LCD_NIBBLE_TO_PORT(nibble)     (((nibble)&0x0F)<<LCD_DB4_PIN_ID)
+#else
+/* The data pins are scattered, every bit is moved to its own pin */
+#define LCD_NIBBLE_TO_PORT(nibble)     ((GET_BIT(nibble,0)<<LCD_DB4_PIN_ID)|(GET_BIT(nibble,1)<<LCD_DB5_PIN_ID)|\
+                                        (GET_BIT(nibble,2)<<LCD_DB6_PIN_ID)|(GET_BIT(nibble,3)<<LCD_DB7_PIN_ID))
+#endif
+
+#elif(LCD_DATA_BITS_MODE == 8)
+
+/* The whole data port is the data bus D0 --> D7 */
+#define LCD_DATA_MASK                  0xFF
+
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Frame to be displayed, written by the application */
+static uint8 g_lcdFrame[LCD_ROWS][LCD_COLS];
+
+/* Copy of what's currently on the screen, used to find the changed cells */
+static uint8 g_lcdShadow[LCD_ROWS][LCD_COLS];
+
+/* Output queue entries, the low byte is the value and LCD_QUEUE_DATA_FLAG selects data (RS=1) */
+#define LCD_QUEUE_DATA_FLAG 0x0100
+static volatile uint16 g_lcdQueue[LCD_QUEUE_SIZE];
+
+/* The main context writes at the head and the ISR reads at the tail */
+static volatile uint8 g_lcdQueueHead=0;
+static volatile uint8 g_lcdQueueTail=0;
+
+/* TRUE while the Timer2 tick is running to drain the queue */
+static volatile boolean g_lcdQueueRunning=FALSE;
+
+/*
+ * LCD address counter as it will be once every written and queued instruction is executed,
+ * it's only used by the main context to skip the redundant cursor moves.
+ */
+#define LCD_ADDRESS_UNKNOWN 0xFF
+static uint8 g_lcdAddress=LCD_ADDRESS_UNKNOWN;
+
+#if(LCD_RW_CONNECTED == FALSE)
+/* Remaining ticks of a slow instruction execution (clear display and return home) */
+static volatile uint8 g_lcdHoldTicks=0;
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Output one byte on the data bus and latch it with the E pulse, in 4-bits mode it's sent as two nibbles.
+ */
+static void LCD_writeBus(uint8 value);
+
+#if(LCD_DATA_BITS_MODE == 4)
+/*
+ * Output the low nibble of the value on DB4 --> DB7 and latch it with the E pulse.
+ */
+static void LCD_writeNibble(uint8 nibble);
+#endif
+
+#if(LCD_RW_CONNECTED == TRUE)
+/*
+ * Read the busy flag once, return TRUE if the LCD is still executing the previous instruction.
+ */
+static boolean LCD_readBusyFlag(void);
+
+/*
+ * Wait until the busy flag is cleared, up to LCD_BUSY_FLAG_TIMEOUT reads.
+ */
+static void LCD_waitBusyFlag(void);
+#endif
+
+/*
+ * Return the LCD DDRAM address of a specified row and column index.
+ */
+static uint8 LCD_getAddress(uint8 row,uint8 col);
+
+/*
+ * Add an entry to the output queue, waiting for a free entry if it's full, and start the tick if it's stopped.
+ */
+static void LCD_enqueue(uint16 entry);
+
+/*
+ * Queue a cursor move to the given DDRAM address, unless the address counter is already there.
+ */
+static void LCD_queueAddress(uint8 address);
+
+/*
+ * Queue a character at the current address.
+ */
+static void LCD_queueCharacter(uint8 data);
+
+/*
+ * Update the tracked address counter after an instruction.
+ */
+static void LCD_trackCommand(uint8 command);
+
+/*
+ * Update the tracked address counter after a data write.
+ */
+static void LCD_trackCharacter(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Initialize the LCD:
+ * 1. Setup the LCD Data Mode 4-bits or 8-bits.
+ * 2. Clear the screen and the frame buffer.
+ * The LCD pins directions are set by Board_init, RW is low (write mode) at boot.
+ */
+void LCD_init(void)
+{
+	/* The output queue tick is the Timer2 compare interrupt, it's enabled only while the queue isn't empty */
+	TimerMgr_claimChannel(TIMER2_COMP_CHANNEL,TIMER_USER_LCD);
+
+	_delay_ms(20);		/* LCD Power ON delay always > 15ms */
+
+#if(LCD_DATA_BITS_MODE == 4)
+	/*
+	 * Send for 4 bit initialization of LCD, the LCD is still in 8-bits mode so every nibble is a whole
+	 * instruction and the busy flag can't be read yet, the datasheet delays are used instead.
+	 */
+	GPIO_WRITE_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
+	LCD_writeNibble(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1>>4);
+	_delay_ms(5); /* > 4.1ms */
+	LCD_writeNibble(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
+	_delay_us(150); /* > 100us */
+	LCD_writeNibble(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2>>4);
+	_delay_us(LCD_EXECUTION_TIME_US);
+	LCD_writeNibble(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
+	_delay_us(LCD_EXECUTION_TIME_US);
+
+	/* use 2-lines LCD + 4-bits Data Mode + 5*7 dot display Mode */
+	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE);
+
+#elif(LCD_DATA_BITS_MODE == 8)
+	/* use 2-lines LCD + 8-bits Data Mode + 5*7 dot display Mode */
+	LCD_sendCommand(LCD_TWO_LINES_EIGHT_BITS_MODE);
+
+#endif
+
+	LCD_sendCommand(LCD_CURSOR_OFF); /* cursor off */
+	LCD_clearScreen(); /* clear LCD at the beginning */
+	LCD_fbClear();
+}
+
+/*
+ * Description :
+ * Send the required command to the screen
+ */
+void LCD_sendCommand(uint8 command)
+{
+	while(LCD_isIdle() == FALSE); /* the queued instructions go first */
+
+#if(LCD_RW_CONNECTED == TRUE)
+	LCD_waitBusyFlag(); /* wait for the previous instruction */
+#endif
+
+	GPIO_WRITE_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
+	LCD_writeBus(command);
+	LCD_trackCommand(command);
+
+#if(LCD_RW_CONNECTED == FALSE)
+	/* wait for the command execution, clear display and return home are much slower than the others */
+	if((command==LCD_CLEAR_COMMAND) || (command==LCD_GO_TO_HOME))
+	{
+		_delay_us(LCD_CLEAR_EXECUTION_TIME_US);
+	}
+	else
+	{
+		_delay_us(LCD_EXECUTION_TIME_US);
+	}
+#endif
+}
+
+/*
+ * Description :
+ * Display the required character on the screen
+ */
+void LCD_displayCharacter(uint8 data)
+{
+	while(LCD_isIdle() == FALSE); /* the queued instructions go first */
+
+#if(LCD_RW_CONNECTED == TRUE)
+	LCD_waitBusyFlag(); /* wait for the previous instruction */
+#endif
+
+	GPIO_WRITE_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
+	LCD_writeBus(data);
+	LCD_trackCharacter();
+
+#if(LCD_RW_CONNECTED == FALSE)
+	_delay_us(LCD_EXECUTION_TIME_US); /* wait for the data write execution */
+#endif
+}
+
+/*
+ * Description :
+ * Display the required string on the screen
+ */
+void LCD_displayString(const char *Str)
+{
+	uint8 i = 0;
+	while(Str[i] != '\0')
+	{
+		LCD_displayCharacter(Str[i]);
+		i++;
+	}
+	/***************** Another Method ***********************
+	while((*Str) != '\0')
+	{
+		LCD_displayCharacter(*Str);
+		Str++;
+	}		
+	*********************************************************/
+}
+
+/*
+ * Description :
+ * Display the required string stored in the flash (PROGMEM) on the screen
+ */
+void LCD_displayString_P(const char *Str)
+{
+	uint8 character = pgm_read_byte(Str);
+	while(character != '\0')
+	{
+		LCD_displayCharacter(character);
+		Str++;
+		character = pgm_read_byte(Str);
+	}
+}
+
+/*
+ * Description :
+ * Move the cursor to a specified row and column index on the screen
+ */
+void LCD_moveCursor(uint8 row,uint8 col)
+{
+	uint8 lcd_memory_address = LCD_getAddress(row,col);
+
+	if(lcd_memory_address == g_lcdAddress)
+	{
+		/* Do Nothing, the cursor is already there */
+	}
+	else
+	{
+		/* Move the LCD cursor to this specific address */
+		LCD_sendCommand(lcd_memory_address | LCD_SET_CURSOR_LOCATION);
+	}
+}
+
+/*
+ * Description :
+ * Display the required string in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
+{
+	/* The move and the string are queued together and written as one batch by the queue ISR */
+	LCD_queueAddress(LCD_getAddress(row,col)); /* go to to the required LCD position */
+	while(*Str != '\0')
+	{
+		LCD_queueCharacter(*Str); /* display the string */
+		Str++;
+	}
+}
+
+/*
+ * Description :
+ * Display the required string stored in the flash (PROGMEM) in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *Str)
+{
+	uint8 character = pgm_read_byte(Str);
+
+	/* The move and the string are queued together and written as one batch by the queue ISR */
+	LCD_queueAddress(LCD_getAddress(row,col)); /* go to to the required LCD position */
+	while(character != '\0')
+	{
+		LCD_queueCharacter(character); /* display the string */
+		Str++;
+		character = pgm_read_byte(Str);
+	}
+}
+
+/*
+ * Description :
+ * Display the required decimal value on the screen
+ */
+void LCD_intgerToString(int data)
+{
+   char buff[16]; /* String to hold the ascii result */
+   itoa(data,buff,10); /* Use itoa C function to convert the data to its corresponding ASCII value, 10 for decimal */
+   LCD_displayString(buff); /* Display the string */
+}
+
+/*
+ * Description :
+ * Send the clear screen command
+ */
+void LCD_clearScreen(void)
+{
+	uint8 row,col;
+
+	LCD_sendCommand(LCD_CLEAR_COMMAND); /* Send clear display command */
+
+	/* The screen is blank now, keep the frame buffer copy in sync */
+	for(row=0;row<LCD_ROWS;row++)
+	{
+		for(col=0;col<LCD_COLS;col++)
+		{
+			g_lcdShadow[row][col]=' ';
+		}
+	}
+}
+
+/*
+ * Description :
+ * Fill the frame buffer with spaces, nothing is sent to the screen until LCD_fbFlush is called
+ */
+void LCD_fbClear(void)
+{
+	uint8 row,col;
+
+	for(row=0;row<LCD_ROWS;row++)
+	{
+		for(col=0;col<LCD_COLS;col++)
+		{
+			g_lcdFrame[row][col]=' ';
+		}
+	}
+}
+
+/*
+ * Description :
+ * Write the required string in the frame buffer at a specified row and column index,
+ * the characters beyond the end of the row are dropped
+ */
+void LCD_fbWrite(uint8 row,uint8 col,const char *Str)
+{
+	if(row>=LCD_ROWS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		while((*Str != '\0') && (col < LCD_COLS))
+		{
+			g_lcdFrame[row][col]=*Str;
+			Str++;
+			col++;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Write the required string stored in the flash (PROGMEM) in the frame buffer at a specified row and
+ * column index, the characters beyond the end of the row are dropped
+ */
+void LCD_fbWrite_P(uint8 row,uint8 col,const char *Str)
+{
+	uint8 character;
+
+	if(row>=LCD_ROWS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		character = pgm_read_byte(Str);
+		while((character != '\0') && (col < LCD_COLS))
+		{
+			g_lcdFrame[row][col]=character;
+			Str++;
+			col++;
+			character = pgm_read_byte(Str);
+		}
+	}
+}
+
+/*
+ * Description :
+ * Queue to the screen only the frame buffer cells that changed since the last flush,
+ * every run of contiguous changed cells costs one cursor move.
+ * It returns as soon as the changes are queued, it only waits if the output queue is full.
+ * NOTE: The frame buffer assumes it's the only writer of the screen, LCD_clearScreen re-synchronizes it.
+ */
+void LCD_fbFlush(void)
+{
+	uint8 row,col;
+
+	for(row=0;row<LCD_ROWS;row++)
+	{
+		for(col=0;col<LCD_COLS;col++)
+		{
+			if(g_lcdFrame[row][col]==g_lcdShadow[row][col])
+			{
+				/* Do Nothing */
+			}
+			else
+			{
+				/* A cursor move is queued only at the start of a run, the address counter is auto incremented */
+				LCD_queueAddress(LCD_getAddress(row,col));
+				LCD_queueCharacter(g_lcdFrame[row][col]);
+				g_lcdShadow[row][col]=g_lcdFrame[row][col];
+			}
+		}
+	}
+}
+
+/*
+ * Description :
+ * Return TRUE if the output queue is empty and the LCD finished the last queued instruction
+ */
+boolean LCD_isIdle(void)
+{
+	return (g_lcdQueueRunning == FALSE);
+}
+
+/*
+ * Description :
+ * Output one byte on the data bus and latch it with the E pulse, in 4-bits mode it's sent as two nibbles.
+ * The E pulse needs only hundreds of nanoseconds, a microsecond delay covers every timing of the bus.
+ */
+static void LCD_writeBus(uint8 value)
+{
+#if(LCD_DATA_BITS_MODE == 4)
+	LCD_writeNibble(value>>4); /* high nibble first */
+	LCD_writeNibble(value);
+
+#elif(LCD_DATA_BITS_MODE == 8)
+	LCD_BUS_DELAY(); /* delay for processing Tas = 50ns */
+	SET_BIT(LCD_E_PORT_REG,LCD_E_PIN_ID); /* Enable LCD E=1 */
+	LCD_DATA_PORT_REG = value; /* out the required value to the data bus D0 --> D7 */
+	LCD_BUS_DELAY(); /* delay for processing Tpw = 230ns */
+	CLEAR_BIT(LCD_E_PORT_REG,LCD_E_PIN_ID); /* Disable LCD E=0 */
+	LCD_BUS_DELAY(); /* delay for processing Th = 13ns and the E cycle time */
+#endif
+}
+
+#if(LCD_DATA_BITS_MODE == 4)
+/*
+ * Description :
+ * Output the low nibble of the value on DB4 --> DB7 and latch it with the E pulse.
+ */
+static void LCD_writeNibble(uint8 nibble)
+{
+	LCD_BUS_DELAY(); /* delay for processing Tas = 50ns */
+	SET_BIT(LCD_E_PORT_REG,LCD_E_PIN_ID); /* Enable LCD E=1 */
+
+	/* out the nibble to DB4 --> DB7 in one write, the other pins of the port keep their values */
+	GPIO_WRITE_MASKED(LCD_DATA_PORT_ID,LCD_DATA_MASK,LCD_NIBBLE_TO_PORT(nibble));
+
+	LCD_BUS_DELAY(); /* delay for processing Tpw = 230ns */
+	CLEAR_BIT(LCD_E_PORT_REG,LCD_E_PIN_ID); /* Disable LCD E=0 */
+	LCD_BUS_DELAY(); /* delay for processing Th = 13ns and the E cycle time */
+}
+#endif
+
+#if(LCD_RW_CONNECTED == TRUE)
+/*
+ * Description :
+ * Read the busy flag once, return TRUE if the LCD is still executing the previous instruction.
+ * The data pins are released before RW is raised, so the MCU and the LCD never drive the bus together.
+ * It doesn't wait, so the queue ISR calls it once per tick.
+ */
+static boolean LCD_readBusyFlag(void)
+{
+	uint8 busy;
+
+	GPIO_CONFIGURE_MASKED(LCD_DATA_PORT_ID,LCD_DATA_MASK,0);
+	GPIO_WRITE_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
+	GPIO_WRITE_PIN(LCD_RW_PORT_ID,LCD_RW_PIN_ID,LOGIC_HIGH); /* Read Mode RW=1 */
+
+	LCD_BUS_DELAY(); /* delay for processing Tas = 50ns */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	LCD_BUS_DELAY(); /* delay for processing Tddr = 160ns */
+	LCD_READ_SYNC_DELAY(); /* the busy flag read of both modes waits for the input synchronizer */
+
+#if(LCD_DATA_BITS_MODE == 4)
+	busy = GPIO_READ_PIN(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID);
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+	LCD_BUS_DELAY();
+
+	/* the low nibble (address counter) must be clocked out too, it's not needed */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	LCD_BUS_DELAY();
+#elif(LCD_DATA_BITS_MODE == 8)
+	busy = GPIO_READ_PIN(LCD_DATA_PORT_ID,LCD_BUSY_FLAG_BIT);
+#endif
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+
+	GPIO_WRITE_PIN(LCD_RW_PORT_ID,LCD_RW_PIN_ID,LOGIC_LOW); /* Write Mode RW=0 */
+	GPIO_CONFIGURE_MASKED(LCD_DATA_PORT_ID,LCD_DATA_MASK,LCD_DATA_MASK);
+
+	return (busy == LOGIC_HIGH);
+}
+
+/*
+ * Description :
+ * Wait until the busy flag is cleared, up to LCD_BUSY_FLAG_TIMEOUT reads so a missing LCD can't hang the MCU.
+ */
+static void LCD_waitBusyFlag(void)
+{
+	uint16 polls = 1;
+
+	while(LCD_readBusyFlag() && (polls < LCD_BUSY_FLAG_TIMEOUT))
+	{
+		polls++;
+	}
+}
+#endif
+
+/*
+ * Description :
+ * Return the LCD DDRAM address of a specified row and column index.
+ */
+static uint8 LCD_getAddress(uint8 row,uint8 col)
+{
+	uint8 lcd_memory_address;
+	
+	/* Calculate the required address in the LCD DDRAM */
+	switch(row)
+	{
+		case 0:
+			lcd_memory_address=col;
+				break;
+		case 1:
+			lcd_memory_address=col+0x40;
+				break;
+		case 2:
+			lcd_memory_address=col+0x10;
+				break;
+		case 3:
+			lcd_memory_address=col+0x50;
+				break;
+	}					
+	return lcd_memory_address;
+}
+
+/*
+ * Description :
+ * Add an entry to the output queue, waiting for a free entry if it's full, and start the tick if it's stopped.
+ * The ISR only stops the tick when it finds the queue empty, so the entry is added before the running flag is checked.
+ */
+static void LCD_enqueue(uint16 entry)
+{
+	uint8 next_head = (g_lcdQueueHead+1) & (LCD_QUEUE_SIZE-1);
+
+	while(next_head == g_lcdQueueTail); /* the queue is full, wait for the ISR to take an entry */
+
+	g_lcdQueue[g_lcdQueueHead] = entry;
+	g_lcdQueueHead = next_head;
+
+	if(g_lcdQueueRunning == FALSE)
+	{
+		/* Start Timer2 in CTC mode at F_CPU/8, the first entry is written on the first tick */
+		g_lcdQueueRunning = TRUE;
+		TCNT2 = 0;
+		OCR2 = LCD_QUEUE_TICK_COUNTS - 1;
+		TCCR2 = (1<<WGM21) | (1<<CS21);
+		TimerMgr_clearFlag(TIMER2_COMP_CHANNEL);
+		TimerMgr_enableInterrupt(TIMER2_COMP_CHANNEL);
+	}
+}
+
+/*
+ * Description :
+ * Queue a cursor move to the given DDRAM address, unless the address counter is already there.
+ */
+static void LCD_queueAddress(uint8 address)
+{
+	if(address == g_lcdAddress)
+	{
+		/* Do Nothing, the cursor is already there */
+	}
+	else
+	{
+		LCD_enqueue(address | LCD_SET_CURSOR_LOCATION);
+		LCD_trackCommand(address | LCD_SET_CURSOR_LOCATION);
+	}
+}
+
+/*
+ * Description :
+ * Queue a character at the current address.
+ */
+static void LCD_queueCharacter(uint8 data)
+{
+	LCD_enqueue(LCD_QUEUE_DATA_FLAG | data);
+	LCD_trackCharacter();
+}
+
+/*
+ * Description :
+ * Update the tracked address counter after an instruction.
+ * Only the instructions that set the DDRAM address are tracked, any other instruction that moves
+ * the address counter or changes its direction makes it unknown until the next cursor move.
+ */
+static void LCD_trackCommand(uint8 command)
+{
+	/* The instruction is decoded from its highest set bit */
+	if(command & LCD_SET_CURSOR_LOCATION)
+	{
+		g_lcdAddress = command & (~LCD_SET_CURSOR_LOCATION); /* Set DDRAM address */
+	}
+	else if(command & 0x40)
+	{
+		g_lcdAddress = LCD_ADDRESS_UNKNOWN; /* Set CGRAM address, the following data goes to the CGRAM */
+	}
+	else if(command & 0x20)
+	{
+		/* Do Nothing, function set keeps the address */
+	}
+	else if(command & 0x10)
+	{
+		g_lcdAddress = LCD_ADDRESS_UNKNOWN; /* Cursor or display shift */
+	}
+	else if(command & 0x08)
+	{
+		/* Do Nothing, display on/off control keeps the address */
+	}
+	else if(command & 0x04)
+	{
+		g_lcdAddress = LCD_ADDRESS_UNKNOWN; /* Entry mode set may change the direction of the address counter */
+	}
+	else if(command != 0)
+	{
+		g_lcdAddress = 0; /* Clear display and return home */
+	}
+	else
+	{
+		/* Do Nothing */
+	}
+}
+
+/*
+ * Description :
+ * Update the tracked address counter after a data write, the counter is incremented and it
+ * wraps from the end of the first line (0x27) to the second line (0x40) and back to 0x00.
+ */
+static void LCD_trackCharacter(void)
+{
+	if(g_lcdAddress == LCD_ADDRESS_UNKNOWN)
+	{
+		/* Do Nothing */
+	}
+	else if(g_lcdAddress == 0x27)
+	{
+		g_lcdAddress = 0x40;
+	}
+	else if(g_lcdAddress == 0x67)
+	{
+		g_lcdAddress = 0x00;
+	}
+	else
+	{
+		g_lcdAddress++;
+	}
+}
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+/*
+ * Output queue tick, it writes one queued entry if the LCD finished the previous instruction,
+ * and stops the tick once the queue is empty and the last instruction is done.
+ */
+ISR(TIMER2_COMP_vect)
+{
+	uint16 entry;
+
+#if(LCD_RW_CONNECTED == TRUE)
+	if(LCD_readBusyFlag())
+	{
+		/* Do Nothing, the LCD is still busy, try again on the next tick */
+	}
+#elif(LCD_RW_CONNECTED == FALSE)
+	if(g_lcdHoldTicks != 0)
+	{
+		g_lcdHoldTicks--;
+	}
+#endif
+	else if(g_lcdQueueTail == g_lcdQueueHead)
+	{
+		TCCR2 = 0;
+		TimerMgr_disableInterrupt(TIMER2_COMP_CHANNEL);
+		g_lcdQueueRunning = FALSE;
+	}
+	else
+	{
+		entry = g_lcdQueue[g_lcdQueueTail];
+		g_lcdQueueTail = (g_lcdQueueTail+1) & (LCD_QUEUE_SIZE-1);
+
+		if(entry & LCD_QUEUE_DATA_FLAG)
+		{
+			GPIO_WRITE_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
+		}
+		else
+		{
+			GPIO_WRITE_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
+		}
+		LCD_writeBus((uint8)entry);
+
+#if(LCD_RW_CONNECTED == FALSE)
+		if((entry == LCD_CLEAR_COMMAND) || (entry == LCD_GO_TO_HOME))
+		{
+			g_lcdHoldTicks = (LCD_CLEAR_EXECUTION_TIME_US/LCD_QUEUE_TICK_US) + 1;
+		}
+#endif
+	}
+}
@@ -1,114 +1,192 @@
- /******************************************************************************
- *
- * Module: LCD
- *
- * File Name: lcd.h
- *
- * Description: Header file for the LCD driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-#ifndef LCD_H_
-#define LCD_H_
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-
-/* LCD Data bits mode configuration, its value should be 4 or 8*/
-#define LCD_DATA_BITS_MODE 8
-
-#if((LCD_DATA_BITS_MODE != 4) && (LCD_DATA_BITS_MODE != 8))
-
-#error "Number of Data bits should be equal to 4 or 8"
-
-#endif
-
-/* LCD HW Ports and Pins Ids */
-#define LCD_RS_PORT_ID                 PORTB_ID
-#define LCD_RS_PIN_ID                  PIN0_ID
-
-#define LCD_E_PORT_ID                  PORTB_ID
-#define LCD_E_PIN_ID                   PIN2_ID
-
-#define LCD_DATA_PORT_ID               PORTC_ID
-
-#if (LCD_DATA_BITS_MODE == 4)
-
-#define LCD_DB4_PIN_ID                 PIN3_ID
-#define LCD_DB5_PIN_ID                 PIN4_ID
-#define LCD_DB6_PIN_ID                 PIN5_ID
-#define LCD_DB7_PIN_ID                 PIN6_ID
-
-#endif
-
-/* LCD Commands */
-#define LCD_CLEAR_COMMAND                    0x01
-#define LCD_GO_TO_HOME                       0x02
-#define LCD_TWO_LINES_EIGHT_BITS_MODE        0x38
-#define LCD_TWO_LINES_FOUR_BITS_MODE         0x28
-#define LCD_TWO_LINES_FOUR_BITS_MODE_INIT1   0x33
-#define LCD_TWO_LINES_FOUR_BITS_MODE_INIT2   0x32
-#define LCD_CURSOR_OFF                       0x0C
-#define LCD_CURSOR_ON                        0x0E
-#define LCD_SET_CURSOR_LOCATION              0x80
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description :
- * Initialize the LCD:
- * 1. Setup the LCD pins directions by use the GPIO driver.
- * 2. Setup the LCD Data Mode 4-bits or 8-bits.
- */
-void LCD_init(void);
-
-/*
- * Description :
- * Send the required command to the screen
- */
-void LCD_sendCommand(uint8 command);
-
-/*
- * Description :
- * Display the required character on the screen
- */
-void LCD_displayCharacter(uint8 data);
-
-/*
- * Description :
- * Display the required string on the screen
- */
-void LCD_displayString(const char *Str);
-
-/*
- * Description :
- * Move the cursor to a specified row and column index on the screen
- */
-void LCD_moveCursor(uint8 row,uint8 col);
-
-/*
- * Description :
- * Display the required string in a specified row and column index on the screen
- */
-void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str);
-
-/*
- * Description :
- * Display the required decimal value on the screen
- */
-void LCD_intgerToString(int data);
-
-/*
- * Description :
- * Send the clear screen command
- */
-void LCD_clearScreen(void);
-
-#endif /* LCD_H_ */
+ /******************************************************************************
+ *
+ * Module: LCD
+ *
+ * File Name: lcd.h
+ *
+ * Description: Header file for the LCD driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+#ifndef LCD_H_
+#define LCD_H_
+
+#include "std_types.h"
+#include "board.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The LCD data bits mode, the RW pin connection and the LCD pins are assigned in board.h */
+
+#if((LCD_DATA_BITS_MODE != 4) && (LCD_DATA_BITS_MODE != 8))
+
+#error "Number of Data bits should be equal to 4 or 8"
+
+#endif
+
+#if((LCD_RW_CONNECTED != TRUE) && (LCD_RW_CONNECTED != FALSE))
+
+#error "LCD RW configuration should be equal to TRUE or FALSE"
+
+#endif
+
+/* Busy flag is the bit 7 of the LCD status register */
+#define LCD_BUSY_FLAG_BIT                    7
+
+/* LCD dimensions, used by the frame buffer */
+#define LCD_ROWS                       2
+#define LCD_COLS                       16
+
+/* Execution times of the LCD instructions in microseconds, used when the busy flag can't be read */
+#define LCD_EXECUTION_TIME_US                50		/* 37us for most of the instructions */
+#define LCD_CLEAR_EXECUTION_TIME_US          1600	/* 1.52ms for clear display and return home */
+
+/* CPU Clock Frequency, used to set the output queue tick */
+#define LCD_F_CPU                            1000000UL
+
+/*
+ * Output queue configuration, the queue is drained by the Timer2 compare interrupt one byte per tick
+ * (two nibbles in 4-bits mode). The tick should be longer than the execution time of an instruction,
+ * the slower instructions (clear display and return home) hold the queue for more ticks.
+ * The busy flag is read once per tick and a busy LCD keeps the entry for the next tick, the tick is
+ * much longer than the LCD needs to leave most of the CPU time to the main context.
+ */
+#define LCD_QUEUE_SIZE                       64		/* entries, it should be a power of 2 */
+#define LCD_QUEUE_TICK_US                    500
+#define LCD_QUEUE_TICK_COUNTS                ((LCD_F_CPU/8UL)*LCD_QUEUE_TICK_US/1000000UL) /* Timer2 counts at F_CPU/8 */
+
+#if((LCD_QUEUE_SIZE & (LCD_QUEUE_SIZE-1)) != 0)
+
+#error "LCD queue size should be a power of 2"
+
+#endif
+
+#if((LCD_QUEUE_TICK_COUNTS < 2) || (LCD_QUEUE_TICK_COUNTS > 256) || (LCD_QUEUE_TICK_US < LCD_EXECUTION_TIME_US))
+
+#error "LCD queue tick should cover the instruction execution time and fit the Timer2 compare register"
+
+#endif
+
+/* Maximum number of busy flag reads before the LCD is assumed ready, so a missing LCD can't hang the MCU */
+#define LCD_BUSY_FLAG_TIMEOUT                2000
+
+/* LCD Commands */
+#define LCD_CLEAR_COMMAND                    0x01
+#define LCD_GO_TO_HOME                       0x02
+#define LCD_TWO_LINES_EIGHT_BITS_MODE        0x38
+#define LCD_TWO_LINES_FOUR_BITS_MODE         0x28
+#define LCD_TWO_LINES_FOUR_BITS_MODE_INIT1   0x33
+#define LCD_TWO_LINES_FOUR_BITS_MODE_INIT2   0x32
+#define LCD_CURSOR_OFF                       0x0C
+#define LCD_CURSOR_ON                        0x0E
+#define LCD_SET_CURSOR_LOCATION              0x80
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Initialize the LCD:
+ * 1. Setup the LCD Data Mode 4-bits or 8-bits.
+ * 2. Clear the screen and the frame buffer.
+ * The LCD pins directions are set by Board_init, RW is low (write mode) at boot.
+ */
+void LCD_init(void);
+
+/*
+ * Description :
+ * Send the required command to the screen
+ * NOTE: It waits for the output queue to drain first, so it shouldn't be called with the interrupts disabled.
+ */
+void LCD_sendCommand(uint8 command);
+
+/*
+ * Description :
+ * Display the required character on the screen
+ * NOTE: It waits for the output queue to drain first, so it shouldn't be called with the interrupts disabled.
+ */
+void LCD_displayCharacter(uint8 data);
+
+/*
+ * Description :
+ * Display the required string on the screen
+ */
+void LCD_displayString(const char *Str);
+
+/*
+ * Description :
+ * Display the required string stored in the flash (PROGMEM) on the screen
+ */
+void LCD_displayString_P(const char *Str);
+
+/*
+ * Description :
+ * Move the cursor to a specified row and column index on the screen
+ */
+void LCD_moveCursor(uint8 row,uint8 col);
+
+/*
+ * Description :
+ * Display the required string in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Display the required string stored in the flash (PROGMEM) in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Display the required decimal value on the screen
+ */
+void LCD_intgerToString(int data);
+
+/*
+ * Description :
+ * Send the clear screen command
+ */
+void LCD_clearScreen(void);
+
+/*
+ * Description :
+ * Fill the frame buffer with spaces, nothing is sent to the screen until LCD_fbFlush is called
+ */
+void LCD_fbClear(void);
+
+/*
+ * Description :
+ * Write the required string in the frame buffer at a specified row and column index,
+ * the characters beyond the end of the row are dropped
+ */
+void LCD_fbWrite(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Write the required string stored in the flash (PROGMEM) in the frame buffer at a specified row and
+ * column index, the characters beyond the end of the row are dropped
+ */
+void LCD_fbWrite_P(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Queue to the screen only the frame buffer cells that changed since the last flush,
+ * every run of contiguous changed cells costs one cursor move.
+ * It returns as soon as the changes are queued, it only waits if the output queue is full.
+ * NOTE: The frame buffer assumes it's the only writer of the screen, LCD_clearScreen re-synchronizes it.
+ */
+void LCD_fbFlush(void);
+
+/*
+ * Description :
+ * Return TRUE if the output queue is empty and the LCD finished the last queued instruction
+ */
+boolean LCD_isIdle(void);
+
+#endif /* LCD_H_ */
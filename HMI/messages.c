@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * Module: Messages
+ *
+ * File Name: messages.c
+ *
+ * Description: Source file for the HMI messages catalog stored in the flash
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "messages.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*
+ * Catalog of the HMI messages, it's kept in the flash so it takes no RAM and
+ * isn't copied at startup like the string literals.
+ */
+static const char g_messages[MSG_NUM_OF_MESSAGES][MESSAGE_MAX_LENGTH] PROGMEM={
+		"Plz Enter Pass: ",		/*MSG_ENTER_PASS*/
+		"Plz Re-Enter the",		/*MSG_REENTER_PASS*/
+		"Same Pass:",			/*MSG_SAME_PASS*/
+		"Wrong Password",		/*MSG_WRONG_PASS*/
+		"ERROR!",				/*MSG_ERROR*/
+		"Correct Password",		/*MSG_CORRECT_PASS*/
+		"Reset Password",		/*MSG_RESET_PASS*/
+		"+ : Open Door",		/*MSG_OPEN_DOOR_OPTION*/
+		"- : Change Pass",		/*MSG_CHANGE_PASS_OPTION*/
+		"Door is ",				/*MSG_DOOR_IS*/
+		"Unlocking",			/*MSG_UNLOCKING*/
+		"Door Unlocked",		/*MSG_DOOR_UNLOCKED*/
+		"Locking",				/*MSG_LOCKING*/
+		" Seconds Left",		/*MSG_SECONDS_LEFT*/
+		"ISR Max Ticks:",		/*MSG_ISR_MAX_TICKS*/
+		"No Door Report"		/*MSG_NO_DOOR_REPORT*/
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to return the flash address of the required message, it should be displayed
+ * with the LCD functions that end with _P.
+ */
+const char *Messages_get(Message_Id id)
+{
+	/*The last byte of every message is always the null terminator, it's returned as an empty message for an invalid id*/
+	const char *message=&g_messages[0][MESSAGE_MAX_LENGTH-1];
+
+	if(id>=MSG_NUM_OF_MESSAGES)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		message=g_messages[id];
+	}
+
+	return message;
+}
@@ -0,0 +1,47 @@
+/******************************************************************************
+ *
+ * Module: Messages
+ *
+ * File Name: messages.h
+ *
+ * Description: Header file for the HMI messages catalog stored in the flash
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef MESSAGES_H_
+#define MESSAGES_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Every message fits one LCD row, plus the null terminator*/
+#define MESSAGE_MAX_LENGTH      17
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*Index of every message in the catalog*/
+typedef enum{
+	MSG_ENTER_PASS,MSG_REENTER_PASS,MSG_SAME_PASS,MSG_WRONG_PASS,MSG_ERROR,MSG_CORRECT_PASS,
+	MSG_RESET_PASS,MSG_OPEN_DOOR_OPTION,MSG_CHANGE_PASS_OPTION,MSG_DOOR_IS,MSG_UNLOCKING,
+	MSG_DOOR_UNLOCKED,MSG_LOCKING,MSG_SECONDS_LEFT,MSG_ISR_MAX_TICKS,MSG_NO_DOOR_REPORT,MSG_NUM_OF_MESSAGES
+}Message_Id;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to return the flash address of the required message, it should be displayed
+ * with the LCD functions that end with _P.
+ */
+const char *Messages_get(Message_Id id);
+
+#endif /* MESSAGES_H_ */
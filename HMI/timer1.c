@@ -1,115 +1,400 @@
-/******************************************************************************
- *
- * Module: Timer1 Driver
- *
- * File Name: timer1.c
- *
- * Description: Source file for AVR Timer1 Driver
- *
- * Author: Mohamed Gad
- *
- *******************************************************************************/
-
-/*******************************************************************************
- *                                Includes                                     *
- *******************************************************************************/
-#include "timer1.h"
-#include <avr/io.h>
-#include <avr/interrupt.h>
-
-/*******************************************************************************
- *                           Global Variables                                  *
- *******************************************************************************/
-/*Global pointer to hold the address of the call back function*/
-static volatile void(*g_callBackPtr)(void)=NULL_PTR;
-
-/*******************************************************************************
- *                       Interrupt Service Routines                            *
- *******************************************************************************/
-/*ISR for the compare mode*/
-ISR(TIMER1_COMPA_vect)
-{
-	if(g_callBackPtr!=NULL_PTR)
-	{
-		(*g_callBackPtr)();
-	}
-}
-
-/*ISR for the overflow mode*/
-ISR(TIMER1_OVF_vect)
-{
-	if(g_callBackPtr!=NULL_PTR)
-	{
-		(*g_callBackPtr)();
-	}
-}
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-/*
- * Description :
- * Function to initialize the Timer driver.
- */
-void Timer1_init(const Timer1_ConfigType * Config_Ptr)
-{
-	switch (Config_Ptr->mode)
-	{
-	case TIMER1_NORMAL_MODE:
-
-
-		TCCR1A=(1<<FOC1A)|(1<<FOC1B); //*  SET FOC1A=1 , FOC1B=1  ----> NON-PWM
-
-		TCNT1=Config_Ptr->initial_value;
-
-		/*Enable Overflow mode interrupt*/
-		TIMSK|=(1<<TOIE1);
-
-		TCCR1B=(Config_Ptr->prescaler<<CS10);
-		break;
-	case TIMER1_COMPARE_MODE:
-
-		TCCR1A=(1<<FOC1A)|(1<<FOC1B); // FOC1A=1 , FOC1B=1  ----> NON-PWM
-
-
-
-		OCR1A=Config_Ptr->compare_value;
-
-
-		TCNT1=Config_Ptr->initial_value;
-
-		/*Enable compare mode interrupt*/
-		TIMSK=(1<<OCIE1A);
-
-		/*
-		 * Set the clock prescaler and start the timer.
-		 * WGM12=1 --> COMPARE MODE
-		 */
-		TCCR1B=(Config_Ptr->prescaler<<CS10)|(1<<WGM12);
-		break;
-	}
-}
-
-/*
- * Description :
- * Function to disable the Timer driver.
- */
-void Timer1_deInit(void)
-{
-	/*Reset all registers*/
-	TCCR1A=0;
-	TCCR1B=0;
-	TIMSK&=~(1<<TOIE1)&~(1<<OCIE1A);
-	TCNT1=0;
-	OCR1A=0;
-}
-
-/*
- * Description :
- * Function to set the Call Back function address.
- */
-void Timer1_setCallBack(void(*a_ptr)(void))
-{
-	/*Assign the address of the call back function to the global pointer*/
-	g_callBackPtr=a_ptr;
-}
+/******************************************************************************
+ *
+ * Module: Timer1 Driver
+ *
+ * File Name: timer1.c
+ *
+ * Description: Source file for AVR Timer1 Driver
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "timer1.h"
+#include "timer_mgr.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "common_macros.h" /* To use the macros like BIT_IS_SET */
+
+#if (TIMER1_OWNER != TIMER_OWNER_TIMER1_DRIVER)
+#error "Timer1 isn't assigned to the Timer1 driver in timer_mgr.h"
+#endif
+
+#if (TIMER1_ISR_PROFILING == 1) && (TIMER0_OWNER != TIMER_OWNER_ISR_PROFILING)
+#error "Timer0 isn't assigned to the Timer1 ISR profiling in timer_mgr.h"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Global pointer to hold the address of the call back function*/
+static volatile void(*g_callBackPtr)(void)=NULL_PTR;
+
+/*Call back function and context of each Timer1 event*/
+static volatile Timer1_CallBackType g_eventCallBackPtr[TIMER1_NUM_OF_EVENTS]={NULL_PTR};
+static void * volatile g_eventContext[TIMER1_NUM_OF_EVENTS]={NULL_PTR};
+
+/*Period of each compare channel, zero means the channel isn't re-armed by its ISR*/
+static volatile uint16 g_channelPeriod[2]={0};
+
+#if (TIMER1_ISR_PROFILING == 1)
+/*Worst-case ISR duration measured so far in Timer0 ticks*/
+static volatile uint8 g_isrMaxTicks=0;
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Function responsible for handling one Timer1 interrupt event: re-arming the periodic
+ * compare channel and calling the event call back.
+ */
+static void Timer1_handleEvent(Timer1_Event event);
+
+#if (TIMER1_ISR_PROFILING == 1)
+/*
+ * Function responsible for recording the duration of the ISR that started at the given
+ * Timer0 count.
+ */
+static void Timer1_profileIsr(uint8 start_ticks);
+#endif
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+/*ISR for the compare mode, and the compare channel A*/
+ISR(TIMER1_COMPA_vect)
+{
+	Timer1_handleEvent(TIMER1_COMPA_EVENT);
+}
+
+/*ISR for the compare channel B*/
+ISR(TIMER1_COMPB_vect)
+{
+	Timer1_handleEvent(TIMER1_COMPB_EVENT);
+}
+
+/*ISR for the overflow mode*/
+ISR(TIMER1_OVF_vect)
+{
+	Timer1_handleEvent(TIMER1_OVF_EVENT);
+}
+
+/*ISR for the input capture*/
+ISR(TIMER1_CAPT_vect)
+{
+	Timer1_handleEvent(TIMER1_CAPT_EVENT);
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to initialize the Timer driver.
+ */
+void Timer1_init(const Timer1_ConfigType * Config_Ptr)
+{
+#if (TIMER1_ISR_PROFILING == 1)
+	/*Start Timer0 as a free running counter for the ISR profiling: Normal mode, F_CPU/8*/
+	TCCR0=(1<<FOC0)|(1<<CS01);
+#endif
+
+	switch (Config_Ptr->mode)
+	{
+	case TIMER1_NORMAL_MODE:
+
+
+		TCCR1A=(1<<FOC1A)|(1<<FOC1B); //*  SET FOC1A=1 , FOC1B=1  ----> NON-PWM
+
+		TCNT1=Config_Ptr->initial_value;
+
+		/*Enable Overflow mode interrupt, if the overflow channel isn't held by another service*/
+		if(TimerMgr_claimChannel(TIMER1_OVF_CHANNEL,TIMER_USER_TIMER1_DRIVER))
+		{
+			TimerMgr_enableInterrupt(TIMER1_OVF_CHANNEL);
+		}
+
+		TCCR1B=(Config_Ptr->prescaler<<CS10);
+		break;
+	case TIMER1_COMPARE_MODE:
+
+		TCCR1A=(1<<FOC1A)|(1<<FOC1B); // FOC1A=1 , FOC1B=1  ----> NON-PWM
+
+
+
+		OCR1A=Config_Ptr->compare_value;
+
+		/*In compare mode the counter is cleared on match, so the channel A isn't re-armed by its ISR*/
+		g_channelPeriod[TIMER1_CHANNEL_A]=0;
+
+
+		TCNT1=Config_Ptr->initial_value;
+
+		/*
+		 * Enable compare mode interrupt, if the channel A isn't held by another service.
+		 * NOTE: TIMSK is shared with Timer0 and Timer2, so only the OCIE1A bit is changed.
+		 */
+		if(TimerMgr_claimChannel(TIMER1_COMPA_CHANNEL,TIMER_USER_TIMER1_DRIVER))
+		{
+			TimerMgr_enableInterrupt(TIMER1_COMPA_CHANNEL);
+		}
+
+		/*
+		 * Set the clock prescaler and start the timer.
+		 * WGM12=1 --> COMPARE MODE
+		 */
+		TCCR1B=(Config_Ptr->prescaler<<CS10)|(1<<WGM12);
+		break;
+	}
+}
+
+/*
+ * Description :
+ * Function to disable the Timer driver.
+ */
+void Timer1_deInit(void)
+{
+	/*Reset all registers*/
+	TCCR1A=0;
+	TCCR1B=0;
+	TimerMgr_releaseChannel(TIMER1_OVF_CHANNEL,TIMER_USER_TIMER1_DRIVER);
+	TimerMgr_releaseChannel(TIMER1_COMPA_CHANNEL,TIMER_USER_TIMER1_DRIVER);
+	TimerMgr_releaseChannel(TIMER1_COMPB_CHANNEL,TIMER_USER_TIMER1_DRIVER);
+	TimerMgr_releaseChannel(TIMER1_CAPT_CHANNEL,TIMER_USER_TIMER1_DRIVER);
+	g_channelPeriod[TIMER1_CHANNEL_A]=0;
+	g_channelPeriod[TIMER1_CHANNEL_B]=0;
+	TCNT1=0;
+	OCR1A=0;
+	OCR1B=0;
+}
+
+/*
+ * Description :
+ * Function to set the Call Back function address.
+ */
+void Timer1_setCallBack(void(*a_ptr)(void))
+{
+	/*Assign the address of the call back function to the global pointer*/
+	g_callBackPtr=a_ptr;
+}
+
+/*
+ * Description :
+ * Function to set the call back function and its context for one Timer1 event.
+ * An event call back has priority over the common call back set by Timer1_setCallBack.
+ */
+void Timer1_setEventCallBack(Timer1_Event event,Timer1_CallBackType a_ptr,void *context)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value;
+
+	if(event>=TIMER1_NUM_OF_EVENTS)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		/*Update the pointer and its context together, so the ISR never sees a mixed pair*/
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+		g_eventCallBackPtr[event]=a_ptr;
+		g_eventContext[event]=context;
+		SREG=sreg_value;
+	}
+}
+
+/*
+ * Description :
+ * Function to start a periodic compare channel on the running counter.
+ * The channel fires every "period" ticks counted from now, independently of the other channel.
+ * NOTE: Timer1 should be initialized in the normal mode, so the counter runs freely up to 0xFFFF.
+ */
+void Timer1_startChannel(Timer1_Channel channel,uint16 period)
+{
+	/*Variable to store the SREG value, to restore the I-bit after arming the channel*/
+	uint8 sreg_value;
+
+	/*The timer manager channel of the required compare channel*/
+	TimerMgr_Channel mgr_channel=(channel==TIMER1_CHANNEL_A)?TIMER1_COMPA_CHANNEL:TIMER1_COMPB_CHANNEL;
+
+	if((channel>TIMER1_CHANNEL_B) || (period==0) || !TimerMgr_claimChannel(mgr_channel,TIMER_USER_TIMER1_DRIVER))
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		/*Read TCNT1 and write the compare register atomically, the 16-bit accesses share the TEMP register*/
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+		g_channelPeriod[channel]=period;
+		if(channel==TIMER1_CHANNEL_A)
+		{
+			OCR1A=TCNT1+period;
+		}
+		else
+		{
+			OCR1B=TCNT1+period;
+		}
+		TimerMgr_clearFlag(mgr_channel);
+		TimerMgr_enableInterrupt(mgr_channel);
+		SREG=sreg_value;
+	}
+}
+
+/*
+ * Description :
+ * Function to stop a compare channel, the other channel keeps running.
+ */
+void Timer1_stopChannel(Timer1_Channel channel)
+{
+	if(channel>TIMER1_CHANNEL_B)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		/*Releasing the channel disables its interrupt*/
+		TimerMgr_releaseChannel((channel==TIMER1_CHANNEL_A)?TIMER1_COMPA_CHANNEL:TIMER1_COMPB_CHANNEL,TIMER_USER_TIMER1_DRIVER);
+		g_channelPeriod[channel]=0;
+	}
+}
+
+/*
+ * Description :
+ * Function to enable the input capture event on the required edge of the ICP1 pin.
+ */
+void Timer1_startCapture(Timer1_CaptureEdge edge)
+{
+	if(TimerMgr_claimChannel(TIMER1_CAPT_CHANNEL,TIMER_USER_TIMER1_DRIVER))
+	{
+		/*ICES1=1 -> capture on the rising edge, ICES1=0 -> capture on the falling edge*/
+		if(edge==TIMER1_CAPTURE_RISING_EDGE)
+		{
+			TCCR1B|=(1<<ICES1);
+		}
+		else
+		{
+			TCCR1B&=~(1<<ICES1);
+		}
+
+		/*Changing the edge may set the capture flag, so clear it before enabling the interrupt*/
+		TimerMgr_clearFlag(TIMER1_CAPT_CHANNEL);
+		TimerMgr_enableInterrupt(TIMER1_CAPT_CHANNEL);
+	}
+}
+
+/*
+ * Description :
+ * Function to disable the input capture event.
+ */
+void Timer1_stopCapture(void)
+{
+	TimerMgr_releaseChannel(TIMER1_CAPT_CHANNEL,TIMER_USER_TIMER1_DRIVER);
+}
+
+/*
+ * Description :
+ * Function to return the counter value latched by the last input capture event.
+ */
+uint16 Timer1_getCaptureValue(void)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the read*/
+	uint8 sreg_value=SREG;
+
+	/*Variable to store the captured value*/
+	uint16 capture_value;
+
+	/*Read the 16-bit register atomically, the 16-bit accesses share the TEMP register*/
+	SREG&=~(1<<7);
+	capture_value=ICR1;
+	SREG=sreg_value;
+
+	return capture_value;
+}
+
+/*
+ * Description :
+ * Function responsible for handling one Timer1 interrupt event: re-arming the periodic
+ * compare channel and calling the event call back.
+ */
+static void Timer1_handleEvent(Timer1_Event event)
+{
+#if (TIMER1_ISR_PROFILING == 1)
+	/*Take the start time, and clear the Timer0 overflow flag to detect an overflow during the ISR*/
+	uint8 start_ticks=TCNT0;
+	TimerMgr_clearFlag(TIMER0_OVF_CHANNEL);
+#endif
+
+	/*Re-arm the periodic channel from its last match, so the ISR latency doesn't accumulate*/
+	if((event==TIMER1_COMPA_EVENT) && (g_channelPeriod[TIMER1_CHANNEL_A]!=0))
+	{
+		OCR1A+=g_channelPeriod[TIMER1_CHANNEL_A];
+	}
+	else if((event==TIMER1_COMPB_EVENT) && (g_channelPeriod[TIMER1_CHANNEL_B]!=0))
+	{
+		OCR1B+=g_channelPeriod[TIMER1_CHANNEL_B];
+	}
+	else
+	{
+		/*Do Nothing*/
+	}
+
+	if(g_eventCallBackPtr[event]!=NULL_PTR)
+	{
+		(*g_eventCallBackPtr[event])(g_eventContext[event]);
+	}
+	else if(((event==TIMER1_COMPA_EVENT) || (event==TIMER1_OVF_EVENT)) && (g_callBackPtr!=NULL_PTR))
+	{
+		/*The common call back serves the compare and the overflow modes*/
+		(*g_callBackPtr)();
+	}
+	else
+	{
+		/*Do Nothing*/
+	}
+
+#if (TIMER1_ISR_PROFILING == 1)
+	Timer1_profileIsr(start_ticks);
+#endif
+}
+
+#if (TIMER1_ISR_PROFILING == 1)
+/*
+ * Description :
+ * Function to return the worst-case Timer1 ISR duration measured so far in Timer0 ticks
+ * (8 CPU cycles each), or TIMER1_ISR_PROFILE_SATURATED if an ISR took 256 ticks or more.
+ */
+uint8 Timer1_getIsrMaxTicks(void)
+{
+	return g_isrMaxTicks;
+}
+
+/*
+ * Description :
+ * Function responsible for recording the duration of the ISR that started at the given
+ * Timer0 count.
+ */
+static void Timer1_profileIsr(uint8 start_ticks)
+{
+	/*Take the end time*/
+	uint8 end_ticks=TCNT0;
+
+	/*Elapsed ticks, the 8-bit subtraction handles a single wrap of TCNT0*/
+	uint8 isr_ticks=(uint8)(end_ticks-start_ticks);
+
+	if(BIT_IS_SET(TIFR,TOV0) && (end_ticks>=start_ticks))
+	{
+		/*Timer0 wrapped and passed the start count again, the ISR ran for a full period or more*/
+		isr_ticks=TIMER1_ISR_PROFILE_SATURATED;
+	}
+
+	if(isr_ticks>g_isrMaxTicks)
+	{
+		g_isrMaxTicks=isr_ticks;
+	}
+}
+#endif
@@ -1,61 +1,142 @@
-/******************************************************************************
- *
- * Module: Timer1 Driver
- *
- * File Name: timer1.h
- *
- * Description: Header file for AVR Timer1 Driver
- *
- * Author: Mohamed Gad
- *
- *******************************************************************************/
-
-#ifndef TIMER1_H_
-#define TIMER1_H_
-
-/*******************************************************************************
- *                                Includes                                     *
- *******************************************************************************/
-#include "std_types.h"
-
-/*******************************************************************************
- *                         Types Declaration                                   *
- *******************************************************************************/
-
-typedef enum{
-	NO_PRESCALER=1,F_CPU_8,F_CPU_64,F_CPU_256,F_CPU_1024
-}Timer1_Prescaler;
-
-typedef enum{
-	TIMER1_NORMAL_MODE,TIMER1_COMPARE_MODE
-}Timer1_Mode;
-
-typedef struct {
-	uint16 initial_value;
-	uint16 compare_value;
-	Timer1_Prescaler prescaler;
-	Timer1_Mode mode;
-} Timer1_ConfigType;
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-/*
- * Description :
- * Function to initialize the Timer driver.
- */
-void Timer1_init(const Timer1_ConfigType * Config_Ptr);
-
-/*
- * Description :
- * Function to disable the Timer driver.
- */
-void Timer1_deInit(void);
-
-/*
- * Description :
- * Function to set the Call Back function address.
- */
-void Timer1_setCallBack(void(*a_ptr)(void));
-
-#endif /* TIMER1_H_ */
+/******************************************************************************
+ *
+ * Module: Timer1 Driver
+ *
+ * File Name: timer1.h
+ *
+ * Description: Header file for AVR Timer1 Driver
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef TIMER1_H_
+#define TIMER1_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Set to 1 to measure the execution time of the Timer1 ISRs (call back included).
+ * Timer0 is used as a free running counter clocked by F_CPU/8 for the measurement, so it should
+ * also be assigned to TIMER_OWNER_ISR_PROFILING in timer_mgr.h. The worst case is shown on the
+ * LCD by pressing '*' in the main options menu.
+ */
+#define TIMER1_ISR_PROFILING            0
+
+/* Duration reported when the ISR outlived one full Timer0 period (256 ticks) */
+#define TIMER1_ISR_PROFILE_SATURATED    0xFF
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum{
+	NO_PRESCALER=1,F_CPU_8,F_CPU_64,F_CPU_256,F_CPU_1024
+}Timer1_Prescaler;
+
+typedef enum{
+	TIMER1_NORMAL_MODE,TIMER1_COMPARE_MODE
+}Timer1_Mode;
+
+/*Timer1 interrupt events, each one has its own call back and context*/
+typedef enum{
+	TIMER1_COMPA_EVENT,TIMER1_COMPB_EVENT,TIMER1_OVF_EVENT,TIMER1_CAPT_EVENT,TIMER1_NUM_OF_EVENTS
+}Timer1_Event;
+
+/*Timer1 compare channels, they share the counter but each one has its own period*/
+typedef enum{
+	TIMER1_CHANNEL_A,TIMER1_CHANNEL_B
+}Timer1_Channel;
+
+/*Input capture trigger edge on the ICP1 pin*/
+typedef enum{
+	TIMER1_CAPTURE_FALLING_EDGE,TIMER1_CAPTURE_RISING_EDGE
+}Timer1_CaptureEdge;
+
+/*Event call back, it receives the context registered with it*/
+typedef void (*Timer1_CallBackType)(void *context);
+
+typedef struct {
+	uint16 initial_value;
+	uint16 compare_value;
+	Timer1_Prescaler prescaler;
+	Timer1_Mode mode;
+} Timer1_ConfigType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to initialize the Timer driver.
+ */
+void Timer1_init(const Timer1_ConfigType * Config_Ptr);
+
+/*
+ * Description :
+ * Function to disable the Timer driver.
+ */
+void Timer1_deInit(void);
+
+/*
+ * Description :
+ * Function to set the Call Back function address.
+ */
+void Timer1_setCallBack(void(*a_ptr)(void));
+
+/*
+ * Description :
+ * Function to set the call back function and its context for one Timer1 event.
+ * An event call back has priority over the common call back set by Timer1_setCallBack.
+ */
+void Timer1_setEventCallBack(Timer1_Event event,Timer1_CallBackType a_ptr,void *context);
+
+/*
+ * Description :
+ * Function to start a periodic compare channel on the running counter.
+ * The channel fires every "period" ticks counted from now, independently of the other channel.
+ * NOTE: Timer1 should be initialized in the normal mode, so the counter runs freely up to 0xFFFF.
+ */
+void Timer1_startChannel(Timer1_Channel channel,uint16 period);
+
+/*
+ * Description :
+ * Function to stop a compare channel, the other channel keeps running.
+ */
+void Timer1_stopChannel(Timer1_Channel channel);
+
+/*
+ * Description :
+ * Function to enable the input capture event on the required edge of the ICP1 pin.
+ */
+void Timer1_startCapture(Timer1_CaptureEdge edge);
+
+/*
+ * Description :
+ * Function to disable the input capture event.
+ */
+void Timer1_stopCapture(void);
+
+/*
+ * Description :
+ * Function to return the counter value latched by the last input capture event.
+ */
+uint16 Timer1_getCaptureValue(void);
+
+#if (TIMER1_ISR_PROFILING == 1)
+/*
+ * Description :
+ * Function to return the worst-case Timer1 ISR duration measured so far in Timer0 ticks
+ * (8 CPU cycles each), or TIMER1_ISR_PROFILE_SATURATED if an ISR took 256 ticks or more.
+ */
+uint8 Timer1_getIsrMaxTicks(void);
+#endif
+
+#endif /* TIMER1_H_ */
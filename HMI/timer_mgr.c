@@ -0,0 +1,116 @@
+/******************************************************************************
+ *
+ * Module: Timer Manager
+ *
+ * File Name: timer_mgr.c
+ *
+ * Description: Source file for the AVR hardware timers resource manager
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "timer_mgr.h"
+#include <avr/io.h> /*To access TIMSK, TIFR and SREG*/
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Current user of each timer channel*/
+static TimerMgr_User g_channelUser[TIMER_NUM_OF_CHANNELS]={TIMER_USER_NONE};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to claim a timer channel for the given user.
+ * Returns TRUE if the channel was free or already held by the same user, FALSE otherwise.
+ */
+boolean TimerMgr_claimChannel(TimerMgr_Channel channel,TimerMgr_User user)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the claim*/
+	uint8 sreg_value;
+
+	/*Variable to store the claim result*/
+	boolean claimed=FALSE;
+
+	if(channel>=TIMER_NUM_OF_CHANNELS)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		/*Test and set the channel user atomically, as a claim may come from an ISR*/
+		sreg_value=SREG;
+		SREG&=~(1<<7);
+		if((g_channelUser[channel]==TIMER_USER_NONE) || (g_channelUser[channel]==user))
+		{
+			g_channelUser[channel]=user;
+			claimed=TRUE;
+		}
+		SREG=sreg_value;
+	}
+
+	return claimed;
+}
+
+/*
+ * Description :
+ * Function to release a timer channel, only its current user can release it.
+ * The channel interrupt is disabled on release.
+ */
+void TimerMgr_releaseChannel(TimerMgr_Channel channel,TimerMgr_User user)
+{
+	if((channel>=TIMER_NUM_OF_CHANNELS) || (g_channelUser[channel]!=user))
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		TimerMgr_disableInterrupt(channel);
+		g_channelUser[channel]=TIMER_USER_NONE;
+	}
+}
+
+/*
+ * Description :
+ * Function to enable the interrupt of a timer channel.
+ * TIMSK is shared by the three timers, so it's updated with an atomic read-modify-write.
+ */
+void TimerMgr_enableInterrupt(TimerMgr_Channel channel)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value=SREG;
+
+	SREG&=~(1<<7);
+	TIMSK|=(1<<channel);
+	SREG=sreg_value;
+}
+
+/*
+ * Description :
+ * Function to disable the interrupt of a timer channel with an atomic read-modify-write.
+ */
+void TimerMgr_disableInterrupt(TimerMgr_Channel channel)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the update*/
+	uint8 sreg_value=SREG;
+
+	SREG&=~(1<<7);
+	TIMSK&=~(1<<channel);
+	SREG=sreg_value;
+}
+
+/*
+ * Description :
+ * Function to clear the pending flag of a timer channel.
+ * TIFR flags are cleared by writing one, so only the required flag is written.
+ */
+void TimerMgr_clearFlag(TimerMgr_Channel channel)
+{
+	TIFR=(1<<channel);
+}
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ * Module: Timestamp
+ *
+ * File Name: timestamp.c
+ *
+ * Description: Source file for the free running microsecond timestamp
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "timestamp.h"
+#include "timer1.h"
+#include "common_macros.h" /*To use macros like BIT_IS_SET*/
+#include <avr/io.h> /*To read the Timer1 counter*/
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Timer1 prescaler for the selected timestamp prescaler*/
+#if (TIMESTAMP_PRESCALER == 1)
+#define TIMESTAMP_TIMER1_PRESCALER  NO_PRESCALER
+#elif (TIMESTAMP_PRESCALER == 8)
+#define TIMESTAMP_TIMER1_PRESCALER  F_CPU_8
+#elif (TIMESTAMP_PRESCALER == 64)
+#define TIMESTAMP_TIMER1_PRESCALER  F_CPU_64
+#elif (TIMESTAMP_PRESCALER == 256)
+#define TIMESTAMP_TIMER1_PRESCALER  F_CPU_256
+#elif (TIMESTAMP_PRESCALER == 1024)
+#define TIMESTAMP_TIMER1_PRESCALER  F_CPU_1024
+#else
+#error "Timer1 doesn't support the selected timestamp prescaler"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Software extension of the counter, holds the high word of the timestamp*/
+static volatile uint32 g_timestampHigh=0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Call back function of the Timer1 overflow event, extends the 16-bit counter.
+ */
+static void Timestamp_overflowCallBack(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to start Timer1 as the free running timestamp counter.
+ * The 16-bit counter is extended by a software high word incremented on every overflow.
+ */
+void Timestamp_init(void)
+{
+	/*Configuration Structure For TIMER1, the counter runs freely from 0 to 0xFFFF*/
+	Timer1_ConfigType Timer1_Config_Struct={
+			0,0,TIMESTAMP_TIMER1_PRESCALER,TIMER1_NORMAL_MODE
+	};
+
+	g_timestampHigh=0;
+	Timer1_setEventCallBack(TIMER1_OVF_EVENT,Timestamp_overflowCallBack,NULL_PTR);
+	Timer1_init(&Timer1_Config_Struct);
+}
+
+/*
+ * Description :
+ * Function to return the current 32-bit timestamp in ticks of TIMESTAMP_US_PER_TICK microseconds.
+ * It's safe to call from the main context and from ISRs, and it wraps around after 2^32 ticks,
+ * so intervals should be computed as an unsigned subtraction of two timestamps.
+ */
+uint32 Timestamp_now(void)
+{
+	/*Variable to store the SREG value, to restore the I-bit after the read*/
+	uint8 sreg_value=SREG;
+
+	/*Variables to store the hardware and software parts of the timestamp*/
+	uint16 low;
+	uint32 high;
+
+	/*TCNT1 is only read here, the 16-bit read is made atomic with the I-bit cleared*/
+	SREG&=~(1<<7);
+	low=TCNT1;
+	high=g_timestampHigh;
+
+	/*
+	 * If the counter overflowed while the interrupts are disabled the ISR didn't run yet,
+	 * the small counter value is after the overflow so account for it here.
+	 */
+	if(BIT_IS_SET(TIFR,TOV1) && (low<0x8000))
+	{
+		high+=0x10000UL;
+	}
+	SREG=sreg_value;
+
+	return high|low;
+}
+
+/*
+ * Description :
+ * Function to return the microseconds elapsed since the given timestamp.
+ */
+uint32 Timestamp_elapsedUs(uint32 start)
+{
+	return TIMESTAMP_TICKS_TO_US(Timestamp_now()-start);
+}
+
+/*
+ * Description :
+ * Call back function of the Timer1 overflow event, extends the 16-bit counter.
+ */
+static void Timestamp_overflowCallBack(void *context)
+{
+	g_timestampHigh+=0x10000UL;
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+ *
+ * Module: Timestamp
+ *
+ * File Name: timestamp.h
+ *
+ * Description: Header file for the free running microsecond timestamp
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef TIMESTAMP_H_
+#define TIMESTAMP_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*CPU Clock Frequency, used to convert the timer ticks into microseconds*/
+#define TIMESTAMP_F_CPU             1000000UL
+
+/*
+ * Timer1 prescaler used as the timestamp clock, it should be 1, 8, 64, 256 or 1024.
+ * The system timer deadlines are all in milliseconds, so the slowest clock is used: every counter
+ * overflow wakes the CPU up, F_CPU/1024 makes it once per 65536 ticks of 128 us (8 MHz) or 1.024 ms (1 MHz).
+ */
+#define TIMESTAMP_PRESCALER         1024
+
+/*Duration of one timestamp tick in microseconds*/
+#define TIMESTAMP_US_PER_TICK       ((TIMESTAMP_PRESCALER*1000000UL)/TIMESTAMP_F_CPU)
+
+/*Convert a number of timestamp ticks into microseconds*/
+#define TIMESTAMP_TICKS_TO_US(ticks)    ((uint32)(ticks)*TIMESTAMP_US_PER_TICK)
+
+/*Convert a number of microseconds into timestamp ticks*/
+#define TIMESTAMP_US_TO_TICKS(us)       ((uint32)(us)/TIMESTAMP_US_PER_TICK)
+
+/*******************************************************************************
+ *                      Preprocessor Error                                     *
+ *******************************************************************************/
+#if ((TIMESTAMP_US_PER_TICK == 0) || ((TIMESTAMP_US_PER_TICK*TIMESTAMP_F_CPU) != (TIMESTAMP_PRESCALER*1000000UL)))
+#error "The timestamp tick should be a whole number of microseconds"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description :
+ * Function to start Timer1 as the free running timestamp counter.
+ * The 16-bit counter is extended by a software high word incremented on every overflow.
+ * Timer1 keeps running freely, so its compare channels remain available to the other services.
+ */
+void Timestamp_init(void);
+
+/*
+ * Description :
+ * Function to return the current 32-bit timestamp in ticks of TIMESTAMP_US_PER_TICK microseconds.
+ * It's safe to call from the main context and from ISRs, and it wraps around after 2^32 ticks,
+ * so intervals should be computed as an unsigned subtraction of two timestamps.
+ */
+uint32 Timestamp_now(void);
+
+/*
+ * Description :
+ * Function to return the microseconds elapsed since the given timestamp.
+ */
+uint32 Timestamp_elapsedUs(uint32 start);
+
+#endif /* TIMESTAMP_H_ */
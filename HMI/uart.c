@@ -1,148 +1,219 @@
- /******************************************************************************
- *
- * Module: UART
- *
- * File Name: uart.c
- *
- * Description: Source file for the UART AVR driver
- *
- * Author: Mohamed Gad
- *
- *******************************************************************************/
-
-#include "uart.h"
-#include "avr/io.h" /* To use the UART Registers */
-#include "common_macros.h" /* To use the macros like SET_BIT */
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-
-/*
- * Description :
- * Functional responsible for Initialize the UART device by:
- * 1. Setup the Frame format like number of data bits, parity bit type and number of stop bits.
- * 2. Enable the UART.
- * 3. Setup the UART baud rate.
- */
-void UART_init(UART_ConfigType * ConfigPtr)
-{
-	uint16 ubrr_value = 0;
-
-	/* U2X = 1 for double transmission speed */
-	UCSRA = (1<<U2X);
-
-	/************************** UCSRB Description **************************
-	 * RXCIE = 0 Disable USART RX Complete Interrupt Enable
-	 * TXCIE = 0 Disable USART Tx Complete Interrupt Enable
-	 * UDRIE = 0 Disable USART Data Register Empty Interrupt Enable
-	 * RXEN  = 1 Receiver Enable
-	 * RXEN  = 1 Transmitter Enable
-	 * UCSZ2 together with UCSZ1 and UCSZ0 specifies the character size in the UART frame.
-	 ***********************************************************************/ 
-	UCSRB=(1<<RXEN)|(1<<TXEN)|(GET_BIT(ConfigPtr->bit_data,2)<<UCSZ2);
-	/************************** UCSRC Description **************************
-	 * URSEL   = 1 The URSEL must be one when writing the UCSRC
-	 * UMSEL   = 0 Asynchronous Operation
-	 * UPM1:0  = 00 Disable parity bit
-	 * USBS    = 0 One stop bit
-	 * UCSZ1:0 = 11 For 8-bit data mode
-	 * UCPOL   = 0 Used with the Synchronous operation only
-	 ***********************************************************************/ 	
-	UCSRC=(1<<URSEL)|(ConfigPtr->parity<<UPM0)|\
-				(ConfigPtr->stop_bit<<USBS)|(GET_BIT(ConfigPtr->bit_data,0)<<UCSZ0)\
-				|(GET_BIT(ConfigPtr->bit_data,1)<<UCSZ1);
-	
-	/* Calculate the UBRR register value */
-	ubrr_value=(uint16)((float64)(UART_F_CPU)/(float64)(8*ConfigPtr->baud_rate))-1;
-
-	/* First 8 bits from the BAUD_PRESCALE inside UBRRL and last 4 bits in UBRRH*/
-	UBRRH = ubrr_value>>8;
-	UBRRL = ubrr_value;
-}
-
-/*
- * Description :
- * Functional responsible for send byte to another UART device.
- */
-void UART_sendByte(const uint8 data)
-{
-	/*
-	 * UDRE flag is set when the Tx buffer (UDR) is empty and ready for
-	 * transmitting a new byte so wait until this flag is set to one
-	 */
-	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
-
-	/*
-	 * Put the required data in the UDR register and it also clear the UDRE flag as
-	 * the UDR register is not empty now
-	 */
-	UDR = data;
-
-	/************************* Another Method *************************
-	UDR = data;
-	while(BIT_IS_CLEAR(UCSRA,TXC)){} // Wait until the transmission is complete TXC = 1
-	SET_BIT(UCSRA,TXC); // Clear the TXC flag
-	*******************************************************************/
-}
-
-/*
- * Description :
- * Functional responsible for receive byte from another UART device.
- */
-uint8 UART_recieveByte(void)
-{
-	/* RXC flag is set when the UART receive data so wait until this flag is set to one */
-	while(BIT_IS_CLEAR(UCSRA,RXC)){}
-
-	/*
-	 * Read the received data from the Rx buffer (UDR)
-	 * The RXC flag will be cleared after read the data
-	 */
-    return UDR;		
-}
-
-/*
- * Description :
- * Send the required string through UART to the other UART device.
- */
-void UART_sendString(const uint8 *Str)
-{
-	uint8 i = 0;
-
-	/* Send the whole string */
-	while(Str[i] != '\0')
-	{
-		UART_sendByte(Str[i]);
-		i++;
-	}
-	/************************* Another Method *************************
-	while(*Str != '\0')
-	{
-		UART_sendByte(*Str);
-		Str++;
-	}		
-	*******************************************************************/
-}
-
-/*
- * Description :
- * Receive the required string until the '#' symbol through UART from the other UART device.
- */
-void UART_receiveString(uint8 *Str)
-{
-	uint8 i = 0;
-
-	/* Receive the first byte */
-	Str[i] = UART_recieveByte();
-
-	/* Receive the whole string until the '#' */
-	while(Str[i] != '#')
-	{
-		i++;
-		Str[i] = UART_recieveByte();
-	}
-
-	/* After receiving the whole string plus the '#', replace the '#' with '\0' */
-	Str[i] = '\0';
-}
+ /******************************************************************************
+ *
+ * Module: UART
+ *
+ * File Name: uart.c
+ *
+ * Description: Source file for the UART AVR driver
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#include "uart.h"
+#include "sys_timer.h" /* To sleep while waiting for a byte and to wake the main context */
+#include "avr/io.h" /* To use the UART Registers */
+#include <avr/interrupt.h> /* For the RX complete ISR */
+#include "common_macros.h" /* To use the macros like SET_BIT */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*
+ * Receive buffer filled by the RX complete ISR. Only the ISR moves the head and only the main context
+ * moves the tail, so each index has a single writer.
+ */
+static volatile uint8 g_uartRxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_uartRxHead=0;
+static volatile uint8 g_uartRxTail=0;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+/*
+ * Store the received byte and wake the main context. Reading UDR clears RXC, so the ISR doesn't run again
+ * for the same byte. A byte received while the buffer is full is dropped.
+ */
+ISR(USART_RXC_vect)
+{
+	uint8 data = UDR;
+	uint8 next = (g_uartRxHead+1)&(UART_RX_BUFFER_SIZE-1);
+
+	if(next == g_uartRxTail)
+	{
+		/*Do Nothing*/
+	}
+	else
+	{
+		g_uartRxBuffer[g_uartRxHead] = data;
+		g_uartRxHead = next;
+	}
+	SysTimer_notify();
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Functional responsible for Initialize the UART device by:
+ * 1. Setup the Frame format like number of data bits, parity bit type and number of stop bits.
+ * 2. Enable the UART.
+ * 3. Setup the UART baud rate.
+ */
+void UART_init(UART_ConfigType * ConfigPtr)
+{
+	uint16 ubrr_value = 0;
+
+	/* U2X = 1 for double transmission speed */
+	UCSRA = (1<<U2X);
+
+	/************************** UCSRB Description **************************
+	 * RXCIE = 1 Enable USART RX Complete Interrupt, the received bytes are buffered by its ISR
+	 * TXCIE = 0 Disable USART Tx Complete Interrupt Enable
+	 * UDRIE = 0 Disable USART Data Register Empty Interrupt Enable
+	 * RXEN  = 1 Receiver Enable
+	 * RXEN  = 1 Transmitter Enable
+	 * UCSZ2 together with UCSZ1 and UCSZ0 specifies the character size in the UART frame.
+	 ***********************************************************************/ 
+	g_uartRxHead=0;
+	g_uartRxTail=0;
+	UCSRB=(1<<RXCIE)|(1<<RXEN)|(1<<TXEN)|(GET_BIT(ConfigPtr->bit_data,2)<<UCSZ2);
+	/************************** UCSRC Description **************************
+	 * URSEL   = 1 The URSEL must be one when writing the UCSRC
+	 * UMSEL   = 0 Asynchronous Operation
+	 * UPM1:0  = 00 Disable parity bit
+	 * USBS    = 0 One stop bit
+	 * UCSZ1:0 = 11 For 8-bit data mode
+	 * UCPOL   = 0 Used with the Synchronous operation only
+	 ***********************************************************************/ 	
+	UCSRC=(1<<URSEL)|(ConfigPtr->parity<<UPM0)|\
+				(ConfigPtr->stop_bit<<USBS)|(GET_BIT(ConfigPtr->bit_data,0)<<UCSZ0)\
+				|(GET_BIT(ConfigPtr->bit_data,1)<<UCSZ1);
+	
+	/* Calculate the UBRR register value */
+	ubrr_value=(uint16)((uint32)(UART_F_CPU)/(8UL*ConfigPtr->baud_rate))-1;
+
+	/* First 8 bits from the BAUD_PRESCALE inside UBRRL and last 4 bits in UBRRH*/
+	UBRRH = ubrr_value>>8;
+	UBRRL = ubrr_value;
+}
+
+/*
+ * Description :
+ * Functional responsible for send byte to another UART device.
+ */
+void UART_sendByte(const uint8 data)
+{
+	/*
+	 * UDRE flag is set when the Tx buffer (UDR) is empty and ready for
+	 * transmitting a new byte so wait until this flag is set to one
+	 */
+	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
+
+	/*
+	 * Put the required data in the UDR register and it also clear the UDRE flag as
+	 * the UDR register is not empty now
+	 */
+	UDR = data;
+
+	/************************* Another Method *************************
+	UDR = data;
+	while(BIT_IS_CLEAR(UCSRA,TXC)){} // Wait until the transmission is complete TXC = 1
+	SET_BIT(UCSRA,TXC); // Clear the TXC flag
+	*******************************************************************/
+}
+
+/*
+ * Description :
+ * Functional responsible for receive byte from another UART device.
+ * The CPU sleeps until the RX complete ISR buffers a byte, it should be called with the I-bit set.
+ */
+uint8 UART_recieveByte(void)
+{
+	uint8 data;
+
+	/* The ISR wakes the CPU up, and SysTimer_idle doesn't sleep over a byte received before it */
+	while(UART_tryRecieveByte(&data) == FALSE)
+	{
+		SysTimer_idle();
+	}
+
+	return data;
+}
+
+/*
+ * Description :
+ * Functional responsible for taking a received byte if there is one, it returns at once.
+ * It returns TRUE and stores the byte if a byte was received, FALSE otherwise.
+ */
+boolean UART_tryRecieveByte(uint8 *data)
+{
+	if(g_uartRxTail == g_uartRxHead)
+	{
+		return FALSE;
+	}
+	else
+	{
+		/* Only the main context moves the tail, the byte is read before the slot is given back to the ISR */
+		*data = g_uartRxBuffer[g_uartRxTail];
+		g_uartRxTail = (g_uartRxTail+1)&(UART_RX_BUFFER_SIZE-1);
+		return TRUE;
+	}
+}
+
+/*
+ * Description :
+ * Functional responsible for dropping the bytes received and not taken yet.
+ * It's used to resynchronize with the other UART device after a lost exchange.
+ */
+void UART_flush(void)
+{
+	g_uartRxTail = g_uartRxHead;
+}
+
+/*
+ * Description :
+ * Send the required string through UART to the other UART device.
+ */
+void UART_sendString(const uint8 *Str)
+{
+	uint8 i = 0;
+
+	/* Send the whole string */
+	while(Str[i] != '\0')
+	{
+		UART_sendByte(Str[i]);
+		i++;
+	}
+	/************************* Another Method *************************
+	while(*Str != '\0')
+	{
+		UART_sendByte(*Str);
+		Str++;
+	}		
+	*******************************************************************/
+}
+
+/*
+ * Description :
+ * Receive the required string until the '#' symbol through UART from the other UART device.
+ */
+void UART_receiveString(uint8 *Str)
+{
+	uint8 i = 0;
+
+	/* Receive the first byte */
+	Str[i] = UART_recieveByte();
+
+	/* Receive the whole string until the '#' */
+	while(Str[i] != '#')
+	{
+		i++;
+		Str[i] = UART_recieveByte();
+	}
+
+	/* After receiving the whole string plus the '#', replace the '#' with '\0' */
+	Str[i] = '\0';
+}
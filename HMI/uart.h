@@ -1,106 +1,124 @@
- /******************************************************************************
- *
- * Module: UART
- *
- * File Name: uart.h
- *
- * Description: Header file for the UART AVR driver
- *
- * Author: Mohamed Gad
- *
- *******************************************************************************/
-
-#ifndef UART_H_
-#define UART_H_
-
-#include "std_types.h"
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-
-/*CPU Clock Frequency, used in calculating The baud rate of the UART to be stored in UBRR register.*/
-#define UART_F_CPU 1000000UL
-
-/*******************************************************************************
- *                               Types Declaration                             *
- *******************************************************************************/
-
-
-typedef enum
-{
-	No_Parity,
-	EVEN_Parity=2,
-	Odd_Parity=3
-}UART_Parity;
-
-
-typedef enum
-{
-	FIVE_BITDATA,
-	SIX_BITDATA,
-	SEVEN_BITDATA,
-	EIGHT_BITDATA,
-	NINE_BITDATA=7
-}UART_BITDATA;
-
-
-typedef enum
-{
-	ONE_BIT,
-	TWO_BITS
-}UART_STOPBIT;
-
-
-typedef uint32 UART_BaudRate;
-
-typedef struct
-{
-	UART_Parity  parity;
-	UART_STOPBIT  stop_bit;
-	UART_BITDATA bit_data;
-	UART_BaudRate  baud_rate;
-
-}UART_ConfigType;
-
-
-
-
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description :
- * Functional responsible for Initialize the UART device by:
- * 1. Setup the Frame format like number of data bits, parity bit type and number of stop bits.
- * 2. Enable the UART.
- * 3. Setup the UART baud rate.
- */
-void UART_init(UART_ConfigType * ConfigPtr);
-
-/*
- * Description :
- * Functional responsible for send byte to another UART device.
- */
-void UART_sendByte(const uint8 data);
-
-/*
- * Description :
- * Functional responsible for receive byte from another UART device.
- */
-uint8 UART_recieveByte(void);
-
-/*
- * Description :
- * Send the required string through UART to the other UART device.
- */
-void UART_sendString(const uint8 *Str);
-
-/*
- * Description :
- * Receive the required string until the '#' symbol through UART from the other UART device.
- */
-void UART_receiveString(uint8 *Str); // Receive until #
-
-#endif /* UART_H_ */
+ /******************************************************************************
+ *
+ * Module: UART
+ *
+ * File Name: uart.h
+ *
+ * Description: Header file for the UART AVR driver
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef UART_H_
+#define UART_H_
+
+#include "std_types.h"
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*CPU Clock Frequency, used in calculating The baud rate of the UART to be stored in UBRR register.*/
+#define UART_F_CPU 1000000UL
+
+/*Size of the receive buffer filled by the RX complete ISR, it should be a power of 2*/
+#define UART_RX_BUFFER_SIZE 16
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+
+typedef enum
+{
+	No_Parity,
+	EVEN_Parity=2,
+	Odd_Parity=3
+}UART_Parity;
+
+
+typedef enum
+{
+	FIVE_BITDATA,
+	SIX_BITDATA,
+	SEVEN_BITDATA,
+	EIGHT_BITDATA,
+	NINE_BITDATA=7
+}UART_BITDATA;
+
+
+typedef enum
+{
+	ONE_BIT,
+	TWO_BITS
+}UART_STOPBIT;
+
+
+typedef uint32 UART_BaudRate;
+
+typedef struct
+{
+	UART_Parity  parity;
+	UART_STOPBIT  stop_bit;
+	UART_BITDATA bit_data;
+	UART_BaudRate  baud_rate;
+
+}UART_ConfigType;
+
+
+
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Functional responsible for Initialize the UART device by:
+ * 1. Setup the Frame format like number of data bits, parity bit type and number of stop bits.
+ * 2. Enable the UART.
+ * 3. Setup the UART baud rate.
+ */
+void UART_init(UART_ConfigType * ConfigPtr);
+
+/*
+ * Description :
+ * Functional responsible for send byte to another UART device.
+ */
+void UART_sendByte(const uint8 data);
+
+/*
+ * Description :
+ * Functional responsible for receive byte from another UART device.
+ * The CPU sleeps until the RX complete ISR buffers a byte, it should be called with the I-bit set.
+ */
+uint8 UART_recieveByte(void);
+
+/*
+ * Description :
+ * Functional responsible for taking a received byte if there is one, it returns at once.
+ * It returns TRUE and stores the byte if a byte was received, FALSE otherwise.
+ */
+boolean UART_tryRecieveByte(uint8 *data);
+
+/*
+ * Description :
+ * Functional responsible for dropping the bytes received and not taken yet.
+ * It's used to resynchronize with the other UART device after a lost exchange.
+ */
+void UART_flush(void);
+
+/*
+ * Description :
+ * Send the required string through UART to the other UART device.
+ */
+void UART_sendString(const uint8 *Str);
+
+/*
+ * Description :
+ * Receive the required string until the '#' symbol through UART from the other UART device.
+ */
+void UART_receiveString(uint8 *Str); // Receive until #
+
+#endif /* UART_H_ */
@@ -0,0 +1,24 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: interrupt.h
+ *
+ * Description: Interrupt macros for the host tests, a test calls the ISRs directly
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef STUB_AVR_INTERRUPT_H_
+#define STUB_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+/*An ISR is a plain function named after its vector*/
+#define ISR(vector)     void vector(void); void vector(void)
+
+#define sei()           do{ SREG|=(1<<7); }while(0)
+#define cli()           do{ SREG&=~(1<<7); }while(0)
+
+#endif /* STUB_AVR_INTERRUPT_H_ */
@@ -0,0 +1,134 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: io.h
+ *
+ * Description: ATmega32 registers as plain variables for the host tests
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef STUB_AVR_IO_H_
+#define STUB_AVR_IO_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *                                Registers                                    *
+ *******************************************************************************/
+/*The registers are defined in avr_stub.c, a test drives the hardware by reading and writing them*/
+extern volatile uint8_t Stub_DDRA,Stub_DDRB,Stub_DDRC,Stub_DDRD,Stub_PORTA,Stub_PORTB,Stub_PORTC,Stub_PORTD;
+extern volatile uint8_t Stub_PINA,Stub_PINB,Stub_PINC,Stub_PIND;
+extern volatile uint8_t GICR,GIFR,MCUCR,MCUCSR,SREG,TIFR,TIMSK;
+extern volatile uint8_t TCCR0,TCNT0,OCR0,TCCR2,TCNT2,OCR2;
+extern volatile uint8_t TCCR1A,TCCR1B;
+extern volatile uint16_t TCNT1,OCR1A,OCR1B,ICR1;
+extern volatile uint8_t TWAR,TWBR,TWCR,TWDR,TWSR;
+extern volatile uint8_t UBRRH,UBRRL,UCSRA,UCSRB,UCSRC,UDR;
+
+/*
+ * With STUB_IO_HOOK defined every access to a port register calls Stub_ioAccess first, so a test can
+ * model a device on the pins: a write is seen by the hook on the next port access.
+ */
+#ifdef STUB_IO_HOOK
+volatile uint8_t *Stub_ioAccess(volatile uint8_t *reg);
+#define STUB_PORT_ACCESS(reg)   (*Stub_ioAccess(&(reg)))
+#else
+#define STUB_PORT_ACCESS(reg)   (reg)
+#endif
+
+#define DDRA    STUB_PORT_ACCESS(Stub_DDRA)
+#define DDRB    STUB_PORT_ACCESS(Stub_DDRB)
+#define DDRC    STUB_PORT_ACCESS(Stub_DDRC)
+#define DDRD    STUB_PORT_ACCESS(Stub_DDRD)
+#define PORTA   STUB_PORT_ACCESS(Stub_PORTA)
+#define PORTB   STUB_PORT_ACCESS(Stub_PORTB)
+#define PORTC   STUB_PORT_ACCESS(Stub_PORTC)
+#define PORTD   STUB_PORT_ACCESS(Stub_PORTD)
+#define PINA    STUB_PORT_ACCESS(Stub_PINA)
+#define PINB    STUB_PORT_ACCESS(Stub_PINB)
+#define PINC    STUB_PORT_ACCESS(Stub_PINC)
+#define PIND    STUB_PORT_ACCESS(Stub_PIND)
+
+/*******************************************************************************
+ *                               Register Bits                                 *
+ *******************************************************************************/
+/*GICR, GIFR, MCUCR and MCUCSR*/
+#define INT0    6
+#define INT1    7
+#define INT2    5
+#define INTF0   6
+#define INTF1   7
+#define INTF2   5
+#define ISC00   0
+#define ISC01   1
+#define ISC10   2
+#define ISC11   3
+#define ISC2    6
+
+/*Timers*/
+#define CS00    0
+#define CS01    1
+#define CS02    2
+#define CS10    0
+#define CS21    1
+#define COM00   4
+#define COM01   5
+#define FOC0    7
+#define FOC1A   3
+#define FOC1B   2
+#define ICES1   6
+#define WGM00   6
+#define WGM01   3
+#define WGM12   3
+#define WGM21   3
+#define TOV0    0
+#define OCF0    1
+#define TOV1    2
+#define OCF1B   3
+#define OCF1A   4
+#define ICF1    5
+#define TOV2    6
+#define OCF2    7
+#define TOIE0   0
+#define OCIE0   1
+#define TOIE1   2
+#define OCIE1B  3
+#define OCIE1A  4
+#define TICIE1  5
+#define TOIE2   6
+#define OCIE2   7
+
+/*TWI*/
+#define TWA0    1
+#define TWGCE   0
+#define TWIE    0
+#define TWEN    2
+#define TWSTO   4
+#define TWSTA   5
+#define TWEA    6
+#define TWINT   7
+#define TWPS0   0
+#define TWPS1   1
+
+/*UART*/
+#define U2X     1
+#define UDRE    5
+#define TXC     6
+#define RXC     7
+#define TXEN    3
+#define RXEN    4
+#define UDRIE   5
+#define TXCIE   6
+#define RXCIE   7
+#define UCSZ2   2
+#define UCSZ0   1
+#define UCSZ1   2
+#define USBS    3
+#define UPM0    4
+#define UPM1    5
+#define URSEL   7
+
+#endif /* STUB_AVR_IO_H_ */
@@ -0,0 +1,22 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: pgmspace.h
+ *
+ * Description: Flash access macros for the host tests, the flash tables are ordinary constants
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef STUB_AVR_PGMSPACE_H_
+#define STUB_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(address)  (*(const uint8_t *)(address))
+#define pgm_read_word(address)  (*(const uint16_t *)(address))
+
+#endif /* STUB_AVR_PGMSPACE_H_ */
@@ -0,0 +1,26 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: sleep.h
+ *
+ * Description: Sleep macros for the host tests, a test may provide Stub_sleepCpu to run the
+ *              hardware until the next interrupt
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef STUB_AVR_SLEEP_H_
+#define STUB_AVR_SLEEP_H_
+
+#define SLEEP_MODE_IDLE         0
+
+void Stub_sleepCpu(void);
+
+#define set_sleep_mode(mode)    do{ (void)(mode); }while(0)
+#define sleep_enable()          do{ }while(0)
+#define sleep_disable()         do{ }while(0)
+#define sleep_cpu()             Stub_sleepCpu()
+
+#endif /* STUB_AVR_SLEEP_H_ */
@@ -0,0 +1,50 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: avr_stub.c
+ *
+ * Description: ATmega32 registers and default hooks for the host tests
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+volatile uint8_t Stub_DDRA,Stub_DDRB,Stub_DDRC,Stub_DDRD,Stub_PORTA,Stub_PORTB,Stub_PORTC,Stub_PORTD;
+volatile uint8_t Stub_PINA,Stub_PINB,Stub_PINC,Stub_PIND;
+volatile uint8_t GICR,GIFR,MCUCR,MCUCSR,SREG,TIFR,TIMSK;
+volatile uint8_t TCCR0,TCNT0,OCR0,TCCR2,TCNT2,OCR2;
+volatile uint8_t TCCR1A,TCCR1B;
+volatile uint16_t TCNT1,OCR1A,OCR1B,ICR1;
+volatile uint8_t TWAR,TWBR,TWCR,TWDR,TWSR;
+volatile uint8_t UBRRH,UBRRL,UCSRA,UCSRB,UCSRC,UDR;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Default hooks, they do nothing. A test that models the time defines its own versions.
+ */
+__attribute__((weak)) void Stub_sleepCpu(void)
+{
+}
+
+__attribute__((weak)) void _delay_ms(double ms)
+{
+	(void)ms;
+}
+
+__attribute__((weak)) void _delay_us(double us)
+{
+	(void)us;
+}
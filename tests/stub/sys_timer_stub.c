@@ -0,0 +1,97 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: sys_timer_stub.c
+ *
+ * Description: Millisecond model of the system timer service for the host tests.
+ *              It replaces sys_timer.c for the tests of the modules that use software timers,
+ *              SysTimer_idle and SysTimer_notify are left to the test.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "sys_timer_stub.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Round a number of system timer ticks to the nearest millisecond*/
+#define STUB_TICKS_TO_MS(ticks)     ((TIMESTAMP_TICKS_TO_US(ticks)+500UL)/1000UL)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef struct{
+	unsigned long next_ms;
+	unsigned long period_ms;
+	SysTimer_CallBackType callBack;
+	void *context;
+	boolean running;
+}Stub_TimerType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+unsigned long Stub_modelMs=0;
+
+static Stub_TimerType g_stubTimers[SYS_TIMER_NUM_OF_TIMERS];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+void SysTimer_start(SysTimer_Id id,uint32 delay,uint32 period,SysTimer_CallBackType a_ptr,void *context)
+{
+	if(id<SYS_TIMER_NUM_OF_TIMERS)
+	{
+		g_stubTimers[id].next_ms=Stub_modelMs+STUB_TICKS_TO_MS(delay);
+		g_stubTimers[id].period_ms=STUB_TICKS_TO_MS(period);
+		g_stubTimers[id].callBack=a_ptr;
+		g_stubTimers[id].context=context;
+		g_stubTimers[id].running=TRUE;
+	}
+}
+
+void SysTimer_stop(SysTimer_Id id)
+{
+	if(id<SYS_TIMER_NUM_OF_TIMERS)
+	{
+		g_stubTimers[id].running=FALSE;
+	}
+}
+
+/*
+ * Run the call backs of the timers expired at Stub_modelMs, a periodic timer is re-armed by its period.
+ */
+void Stub_runTimers(void)
+{
+	uint8 id;
+
+	for(id=0;id<SYS_TIMER_NUM_OF_TIMERS;id++)
+	{
+		if(g_stubTimers[id].running && (Stub_modelMs>=g_stubTimers[id].next_ms))
+		{
+			if(g_stubTimers[id].period_ms==0)
+			{
+				g_stubTimers[id].running=FALSE;
+			}
+			else
+			{
+				g_stubTimers[id].next_ms+=g_stubTimers[id].period_ms;
+			}
+			(*g_stubTimers[id].callBack)(g_stubTimers[id].context);
+		}
+	}
+}
+
+/*
+ * Return TRUE if the given timer is running.
+ */
+boolean Stub_timerRunning(SysTimer_Id id)
+{
+	return (id<SYS_TIMER_NUM_OF_TIMERS)?g_stubTimers[id].running:FALSE;
+}
@@ -0,0 +1,41 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: sys_timer_stub.h
+ *
+ * Description: Millisecond model of the system timer service for the host tests
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef SYS_TIMER_STUB_H_
+#define SYS_TIMER_STUB_H_
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "sys_timer.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Model time in milliseconds, a test advances it and then calls Stub_runTimers*/
+extern unsigned long Stub_modelMs;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Run the call backs of the timers expired at Stub_modelMs, a periodic timer is re-armed by its period.
+ * SysTimer_start and SysTimer_stop are defined by the stub, the delays are rounded to whole milliseconds.
+ */
+void Stub_runTimers(void);
+
+/*
+ * Return TRUE if the given timer is running.
+ */
+boolean Stub_timerRunning(SysTimer_Id id);
+
+#endif /* SYS_TIMER_STUB_H_ */
@@ -0,0 +1,20 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: atomic.h
+ *
+ * Description: Atomic block macros for the host tests, the tests run in a single thread
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef STUB_UTIL_ATOMIC_H_
+#define STUB_UTIL_ATOMIC_H_
+
+#define ATOMIC_RESTORESTATE     0
+#define ATOMIC_FORCEON          0
+#define ATOMIC_BLOCK(type)      for(int atomic_once=1;atomic_once;atomic_once=0)
+
+#endif /* STUB_UTIL_ATOMIC_H_ */
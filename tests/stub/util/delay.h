@@ -0,0 +1,20 @@
+/******************************************************************************
+ *
+ * Module: Host Test Stubs
+ *
+ * File Name: delay.h
+ *
+ * Description: Busy wait functions for the host tests, a test may provide its own
+ *              definitions to advance its hardware model
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef STUB_UTIL_DELAY_H_
+#define STUB_UTIL_DELAY_H_
+
+void _delay_ms(double ms);
+void _delay_us(double us);
+
+#endif /* STUB_UTIL_DELAY_H_ */
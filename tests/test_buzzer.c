@@ -0,0 +1,212 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_buzzer.c
+ *
+ * Description: Test of the buzzer pattern player of the Control ECU.
+ *              The system timer is the millisecond model of the stubs, the buzzer pin is
+ *              sampled every millisecond and its edges are checked against the pattern steps.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "test_common.h"
+#include "buzzer.h"
+#include "sys_timer_stub.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Edges recorded at most in one run*/
+#define TEST_MAX_EDGES              64
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Edges of the buzzer pin since the start of the run, in ms from the start*/
+static unsigned long g_edgeTime[TEST_MAX_EDGES];
+static uint8 g_edgeCount=0;
+static uint8 g_lastLevel=BUZZER_OFF;
+static unsigned long g_runStart=0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Level of the buzzer pin.
+ */
+static uint8 Test_buzzerLevel(void)
+{
+	return BIT_IS_SET(GPIO_PORT_REG(BUZZER_CNTRL_PORT_ID),BUZZER_CNTRL_PIN_ID)?LOGIC_HIGH:LOGIC_LOW;
+}
+
+/*
+ * Sample the buzzer pin and record its edge if it changed.
+ */
+static void Test_sample(void)
+{
+	uint8 level=Test_buzzerLevel();
+
+	if(level!=g_lastLevel)
+	{
+		if(g_edgeCount<TEST_MAX_EDGES)
+		{
+			g_edgeTime[g_edgeCount]=Stub_modelMs-g_runStart;
+			g_edgeCount++;
+		}
+		g_lastLevel=level;
+	}
+}
+
+/*
+ * Start a new record of the buzzer edges, the level set by Buzzer_play at the start isn't an edge.
+ */
+static void Test_startRecord(void)
+{
+	g_runStart=Stub_modelMs;
+	g_edgeCount=0;
+	g_lastLevel=Test_buzzerLevel();
+}
+
+/*
+ * Run the model for the given milliseconds, the timer expires before the pin is sampled.
+ */
+static void Test_runMs(unsigned long ms)
+{
+	while(ms>0)
+	{
+		Stub_modelMs++;
+		ms--;
+		Stub_runTimers();
+		Test_sample();
+	}
+}
+
+/*
+ * Check the recorded edges against the expected ones.
+ */
+static void Test_checkEdges(const unsigned long *expected,uint8 count)
+{
+	uint8 i;
+
+	TEST_CHECK_EQUAL(g_edgeCount,count);
+	for(i=0;(i<count) && (i<g_edgeCount);i++)
+	{
+		TEST_CHECK_EQUAL(g_edgeTime[i],expected[i]);
+	}
+}
+
+/*
+ * A pattern ending with BUZZER_PATTERN_END plays each step for its duration, then stops with the buzzer off.
+ */
+static void Test_endingPatterns(void)
+{
+	static const unsigned long click[]={20};
+	static const unsigned long success[]={60,100,160,200,400};
+
+	Buzzer_play(BUZZER_PATTERN_KEY_CLICK);
+	Test_startRecord();
+	TEST_CHECK_EQUAL(Test_buzzerLevel(),BUZZER_ON);
+	TEST_CHECK(Buzzer_isPlaying());
+	TEST_CHECK(Stub_timerRunning(SYS_TIMER_BUZZER));
+	Test_runMs(1000);
+	Test_checkEdges(click,sizeof(click)/sizeof(click[0]));
+	TEST_CHECK(Buzzer_isPlaying()==FALSE);
+	TEST_CHECK(Stub_timerRunning(SYS_TIMER_BUZZER)==FALSE);
+	TEST_CHECK_EQUAL(Test_buzzerLevel(),BUZZER_OFF);
+
+	Buzzer_play(BUZZER_PATTERN_SUCCESS);
+	Test_startRecord();
+	TEST_CHECK_EQUAL(Test_buzzerLevel(),BUZZER_ON);
+	Test_runMs(1000);
+	Test_checkEdges(success,sizeof(success)/sizeof(success[0]));
+	TEST_CHECK(Buzzer_isPlaying()==FALSE);
+	TEST_CHECK_EQUAL(Test_buzzerLevel(),BUZZER_OFF);
+}
+
+/*
+ * A pattern ending with BUZZER_PATTERN_REPEAT plays again from its start without a gap, until Buzzer_off.
+ */
+static void Test_repeatingPatterns(void)
+{
+	unsigned long expected[TEST_MAX_EDGES];
+	uint8 i;
+
+	/*Alarm: 250 ms on then 250 ms off, for 3 s*/
+	Buzzer_play(BUZZER_PATTERN_ALARM);
+	Test_startRecord();
+	Test_runMs(3000-1);
+	for(i=0;i<11;i++)
+	{
+		expected[i]=(i+1UL)*250UL;
+	}
+	Test_checkEdges(expected,11);
+	TEST_CHECK(Buzzer_isPlaying());
+
+	Buzzer_off();
+	TEST_CHECK(Buzzer_isPlaying()==FALSE);
+	TEST_CHECK(Stub_timerRunning(SYS_TIMER_BUZZER)==FALSE);
+	TEST_CHECK_EQUAL(Test_buzzerLevel(),BUZZER_OFF);
+
+	/*Low battery: 50 ms on every 2 s*/
+	Buzzer_play(BUZZER_PATTERN_LOW_BATTERY);
+	Test_startRecord();
+	Test_runMs(6000-1);
+	for(i=0;i<3;i++)
+	{
+		expected[(2*i)]=(i*2000UL)+50UL;
+		expected[(2*i)+1]=(i+1UL)*2000UL;
+	}
+	Test_checkEdges(expected,5);
+	Buzzer_off();
+}
+
+/*
+ * A new pattern or a solid tone replaces the running pattern, an unknown pattern is ignored.
+ */
+static void Test_replacing(void)
+{
+	static const unsigned long click[]={20};
+
+	Buzzer_play(BUZZER_PATTERN_ALARM);
+	Test_runMs(100);
+
+	Buzzer_play(BUZZER_PATTERN_KEY_CLICK);
+	Test_startRecord();
+	Test_runMs(1000);
+	Test_checkEdges(click,1);
+
+	Buzzer_play(BUZZER_PATTERN_ALARM);
+	Test_runMs(300);
+	Buzzer_on();
+	TEST_CHECK(Buzzer_isPlaying()==FALSE);
+	TEST_CHECK(Stub_timerRunning(SYS_TIMER_BUZZER)==FALSE);
+	Test_startRecord();
+	Test_runMs(1000);
+	TEST_CHECK_EQUAL(g_edgeCount,0);
+	TEST_CHECK_EQUAL(Test_buzzerLevel(),BUZZER_ON);
+
+	Buzzer_play(BUZZER_NUM_OF_PATTERNS);
+	TEST_CHECK(Buzzer_isPlaying()==FALSE);
+	TEST_CHECK_EQUAL(Test_buzzerLevel(),BUZZER_ON);
+	Buzzer_off();
+	TEST_CHECK_EQUAL(Test_buzzerLevel(),BUZZER_OFF);
+}
+
+int main(void)
+{
+	SREG=(1<<7);
+	Buzzer_init();
+
+	Test_endingPatterns();
+	Test_repeatingPatterns();
+	Test_replacing();
+
+	return TEST_RESULT("test_buzzer");
+}
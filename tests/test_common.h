@@ -0,0 +1,50 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_common.h
+ *
+ * Description: Check macros shared by the host tests
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+#ifndef TEST_COMMON_H_
+#define TEST_COMMON_H_
+
+#include <stdio.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Number of failed checks of the test, the test exits with it*/
+static int g_testFailures=0;
+
+/*Check a condition, a failure is reported with its location and the test goes on*/
+#define TEST_CHECK(condition) \
+	do{ \
+		if(!(condition)) \
+		{ \
+			printf("%s:%d: check failed: %s\n",__FILE__,__LINE__,#condition); \
+			g_testFailures++; \
+		} \
+	}while(0)
+
+/*Check two integer values, both are printed on a failure*/
+#define TEST_CHECK_EQUAL(actual,expected) \
+	do{ \
+		long test_actual=(long)(actual); \
+		long test_expected=(long)(expected); \
+		if(test_actual!=test_expected) \
+		{ \
+			printf("%s:%d: check failed: %s is %ld, expected %ld\n",__FILE__,__LINE__,#actual,test_actual,test_expected); \
+			g_testFailures++; \
+		} \
+	}while(0)
+
+/*Report the result of the test, it's the return value of main*/
+#define TEST_RESULT(name) \
+	((g_testFailures==0)?(printf("%s: passed\n",name),0):(printf("%s: %d check(s) failed\n",name,g_testFailures),1))
+
+#endif /* TEST_COMMON_H_ */
@@ -0,0 +1,343 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_door.c
+ *
+ * Description: Test of the door travel of the Control ECU on a model of the door mechanism.
+ *              The motion profile drives a model of the motor and the door, the door closes
+ *              the end stop switches on PD2 and PD3 and their edges run the INT0 and INT1 ISRs
+ *              of the external interrupt driver. The system timer is the millisecond model of the stubs.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "test_common.h"
+#include "motion.h"
+#include "position.h"
+#include "pwm.h"
+#include "CONTROL_ECU.h"
+#include "sys_timer_stub.h"
+#include <avr/io.h>
+
+#if ((DOOR_OPEN_LIMIT_PORT_ID != PORTD_ID) || (DOOR_CLOSED_LIMIT_PORT_ID != PORTD_ID) || (DOOR_ENCODER_CONNECTED != FALSE))
+#error "The door model follows the board wiring: end stop switches on PORTD, no encoder"
+#endif
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*The model runs in steps of 1 ms, the speeds are in door lengths per 1000 s at the full duty*/
+#define MODEL_FULL_SPEED            1000L
+
+/*Time constant of the motor speed, in ms*/
+#define MODEL_TIME_CONSTANT_MS      150L
+
+/*Nominal door length, in the position unit of the model (1/1000000 of the full speed second)*/
+#define MODEL_NOMINAL_LENGTH        13000000L
+
+/*External interrupt ISRs, called by the model*/
+void INT0_vect(void);
+void INT1_vect(void);
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*Result of one travel of the model*/
+typedef struct{
+	unsigned long time_ms;
+	long speed_at_stop;
+	long position;
+	boolean done;
+}Test_TravelType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Door profile of the Control ECU*/
+static const Motion_ProfileType g_doorProfile={
+		DOOR_MOTION_TIME_MS,DOOR_ACCEL_TIME_MS,DOOR_DECEL_TIME_MS,DOOR_APPROACH_TIME_MS,DOOR_OVERRUN_TIME_MS,
+		DOOR_CRUISE_DUTY,DOOR_APPROACH_DUTY
+};
+
+/*Motor output*/
+static DcMotor_State g_motorState=STOP;
+static uint8 g_motorDuty=0;
+
+/*Door: length, position from the closed end and speed, the speed is in position units per ms*/
+static long g_doorLength=MODEL_NOMINAL_LENGTH;
+static long g_doorPosition=0;
+static long g_doorSpeed=0;
+
+/*Switch bounces left to play on the next switch closing*/
+static uint8 g_switchBounces=0;
+
+/*Calls of the done call back and of SysTimer_notify*/
+static uint8 g_doneCount=0;
+static unsigned long g_notifyCount=0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Wake up request of the switch ISRs, it's counted.
+ */
+void SysTimer_notify(void)
+{
+	g_notifyCount++;
+}
+
+/*
+ * Motor driver replacements, they set the motor output of the model.
+ */
+void DcMotor_drive(DcMotor_State state,uint8 duty)
+{
+	g_motorState=state;
+	g_motorDuty=(state==STOP)?0:duty;
+}
+
+void PWM_Timer0_setDuty(uint8 duty)
+{
+	g_motorDuty=duty;
+}
+
+/*
+ * Done call back of the travels.
+ */
+static void Test_doneCallBack(void *context)
+{
+	g_doneCount++;
+}
+
+/*
+ * Drive the switch pins from the door position, a switch closing gives a falling edge that runs its ISR
+ * if the line is enabled. A bouncing switch opens and closes again before it settles.
+ */
+static void DoorModel_switches(void)
+{
+	uint8 old_pins=Stub_PIND;
+	uint8 pins=Stub_PIND|(1<<DOOR_OPEN_LIMIT_PIN_ID)|(1<<DOOR_CLOSED_LIMIT_PIN_ID);
+
+	if(g_doorPosition>=g_doorLength)
+	{
+		pins&=~(1<<DOOR_OPEN_LIMIT_PIN_ID);
+	}
+	if(g_doorPosition<=0)
+	{
+		pins&=~(1<<DOOR_CLOSED_LIMIT_PIN_ID);
+	}
+
+	do
+	{
+		Stub_PIND=pins;
+		if((old_pins&(1<<DOOR_OPEN_LIMIT_PIN_ID)) && !(pins&(1<<DOOR_OPEN_LIMIT_PIN_ID)) && (GICR&(1<<INT0)))
+		{
+			INT0_vect();
+		}
+		if((old_pins&(1<<DOOR_CLOSED_LIMIT_PIN_ID)) && !(pins&(1<<DOOR_CLOSED_LIMIT_PIN_ID)) && (GICR&(1<<INT1)))
+		{
+			INT1_vect();
+		}
+		if((g_switchBounces>0) && ((old_pins&(uint8)~pins)!=0))
+		{
+			/*The contact opens again for a moment*/
+			g_switchBounces--;
+			Stub_PIND=old_pins;
+		}
+		else
+		{
+			break;
+		}
+	}while(1);
+}
+
+/*
+ * Run the model for one millisecond: the system timer, then the motor speed follows the duty
+ * and the door moves until it hits an end.
+ */
+static void DoorModel_step(void)
+{
+	long target;
+
+	Stub_modelMs++;
+	Stub_runTimers();
+
+	target=(MODEL_FULL_SPEED*g_motorDuty)/PWM_MAX_DUTY;
+	if(g_motorState==POSITION_CLOSE_DIRECTION)
+	{
+		target=-target;
+	}
+	else if(g_motorState==STOP)
+	{
+		target=0;
+	}
+	if(((target-g_doorSpeed)<MODEL_TIME_CONSTANT_MS) && ((g_doorSpeed-target)<MODEL_TIME_CONSTANT_MS))
+	{
+		g_doorSpeed=target;
+	}
+	else
+	{
+		g_doorSpeed+=(target-g_doorSpeed)/MODEL_TIME_CONSTANT_MS;
+	}
+	g_doorPosition+=g_doorSpeed;
+	if(g_doorPosition>=g_doorLength)
+	{
+		g_doorPosition=g_doorLength;
+	}
+	else if(g_doorPosition<=0)
+	{
+		g_doorPosition=0;
+	}
+	DoorModel_switches();
+}
+
+/*
+ * Place the door at a position, at rest.
+ */
+static void DoorModel_place(long length,long position)
+{
+	g_doorLength=length;
+	g_doorPosition=position;
+	g_doorSpeed=0;
+	g_motorState=STOP;
+	g_motorDuty=0;
+	g_switchBounces=0;
+	DoorModel_switches();
+}
+
+/*
+ * Run one door travel like the Control ECU does, until the done call back or 60 s.
+ */
+static Test_TravelType Test_travel(DcMotor_State direction)
+{
+	Test_TravelType result;
+	unsigned long start=Stub_modelMs;
+	long speed=0;
+
+	g_doneCount=0;
+	Motion_start(direction,&g_doorProfile,Test_doneCallBack,NULL_PTR);
+	Position_checkReached();
+	while((g_doneCount==0) && ((Stub_modelMs-start)<60000UL))
+	{
+		speed=g_doorSpeed;
+		DoorModel_step();
+	}
+
+	result.time_ms=Stub_modelMs-start;
+	result.speed_at_stop=(speed<0)?-speed:speed;
+	result.position=g_doorPosition;
+	result.done=(g_doneCount==1);
+
+	/*Let the door come to rest*/
+	while((g_doorSpeed!=0) && ((Stub_modelMs-start)<120000UL))
+	{
+		DoorModel_step();
+	}
+	return result;
+}
+
+/*
+ * On the nominal door each travel ends on its end stop switch, during the approach and at the approach speed.
+ * The switch ISRs wake the main context.
+ */
+static void Test_nominalDoor(void)
+{
+	Test_TravelType open_travel;
+	Test_TravelType close_travel;
+	long approach_speed=(MODEL_FULL_SPEED*DOOR_APPROACH_DUTY)/PWM_MAX_DUTY;
+
+	DoorModel_place(MODEL_NOMINAL_LENGTH,0);
+	g_notifyCount=0;
+	open_travel=Test_travel(POSITION_OPEN_DIRECTION);
+	TEST_CHECK(open_travel.done);
+	TEST_CHECK_EQUAL(open_travel.position,MODEL_NOMINAL_LENGTH);
+	TEST_CHECK(open_travel.time_ms>(DOOR_MOTION_TIME_MS-DOOR_APPROACH_TIME_MS));
+	TEST_CHECK(open_travel.time_ms<(DOOR_MOTION_TIME_MS+DOOR_OVERRUN_TIME_MS));
+	TEST_CHECK(open_travel.speed_at_stop<=(approach_speed+(approach_speed/10)));
+	TEST_CHECK_EQUAL(g_notifyCount,1);
+	TEST_CHECK_EQUAL(g_motorState,STOP);
+
+	close_travel=Test_travel(POSITION_CLOSE_DIRECTION);
+	TEST_CHECK(close_travel.done);
+	TEST_CHECK_EQUAL(close_travel.position,0);
+	TEST_CHECK(close_travel.speed_at_stop<=(approach_speed+(approach_speed/10)));
+	TEST_CHECK_EQUAL(g_notifyCount,2);
+
+	printf("nominal door: open %lu ms, close %lu ms, end stop speed %ld%% of full\n",
+			open_travel.time_ms,close_travel.time_ms,(open_travel.speed_at_stop*100)/MODEL_FULL_SPEED);
+}
+
+/*
+ * A shorter door ends its travel earlier, a longer one ends during the overrun time.
+ */
+static void Test_doorLengths(void)
+{
+	Test_TravelType travel;
+
+	DoorModel_place(MODEL_NOMINAL_LENGTH-3000000L,0);
+	travel=Test_travel(POSITION_OPEN_DIRECTION);
+	TEST_CHECK(travel.done);
+	TEST_CHECK(travel.time_ms<(DOOR_MOTION_TIME_MS-DOOR_APPROACH_TIME_MS-DOOR_DECEL_TIME_MS));
+
+	DoorModel_place(MODEL_NOMINAL_LENGTH+1000000L,0);
+	travel=Test_travel(POSITION_OPEN_DIRECTION);
+	TEST_CHECK(travel.done);
+	TEST_CHECK_EQUAL(travel.position,MODEL_NOMINAL_LENGTH+1000000L);
+	TEST_CHECK(travel.time_ms>DOOR_MOTION_TIME_MS);
+	TEST_CHECK(travel.time_ms<(DOOR_MOTION_TIME_MS+DOOR_OVERRUN_TIME_MS));
+}
+
+/*
+ * A travel starting on its end stop ends at once, no edge comes from the closed switch.
+ */
+static void Test_startAtEnd(void)
+{
+	Test_TravelType travel;
+
+	DoorModel_place(MODEL_NOMINAL_LENGTH,0);
+	travel=Test_travel(POSITION_CLOSE_DIRECTION);
+	TEST_CHECK(travel.done);
+	TEST_CHECK_EQUAL(travel.time_ms,0);
+	TEST_CHECK_EQUAL(g_motorState,STOP);
+}
+
+/*
+ * A bouncing switch ends the travel once, and a door that never reaches its switch stops after the overrun time.
+ */
+static void Test_switchFaults(void)
+{
+	Test_TravelType travel;
+
+	DoorModel_place(MODEL_NOMINAL_LENGTH,0);
+	g_switchBounces=5;
+	g_notifyCount=0;
+	travel=Test_travel(POSITION_OPEN_DIRECTION);
+	TEST_CHECK(travel.done);
+	TEST_CHECK_EQUAL(g_doneCount,1);
+	TEST_CHECK(g_notifyCount>1);
+
+	/*The switch is out of reach*/
+	DoorModel_place(MODEL_NOMINAL_LENGTH*10,0);
+	travel=Test_travel(POSITION_OPEN_DIRECTION);
+	TEST_CHECK(travel.done);
+	TEST_CHECK_EQUAL(travel.time_ms,DOOR_MOTION_TIME_MS+DOOR_OVERRUN_TIME_MS);
+	TEST_CHECK_EQUAL(g_motorState,STOP);
+}
+
+int main(void)
+{
+	SREG=(1<<7);
+	Stub_PIND=0xFF;
+	Position_init();
+
+	Test_nominalDoor();
+	Test_doorLengths();
+	Test_startAtEnd();
+	Test_switchFaults();
+
+	return TEST_RESULT("test_door");
+}
@@ -0,0 +1,225 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_gpio.c
+ *
+ * Description: Test of the constant pin access macros of the GPIO driver against its functions.
+ *              Both must leave the same port registers, and a macro must reach its register
+ *              in a single access. The instructions it compiles to on the AVR are not checked here.
+ *              The macros only build with constant port and pin numbers, so every pin is expanded.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "test_common.h"
+#include "gpio.h"
+#include "common_macros.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+#define TEST_NUM_OF_REGS            12
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*All the port registers, DDR then PORT then PIN of each port*/
+static volatile uint8_t * const g_regs[TEST_NUM_OF_REGS]={
+	&Stub_DDRA,&Stub_PORTA,&Stub_PINA,&Stub_DDRB,&Stub_PORTB,&Stub_PINB,
+	&Stub_DDRC,&Stub_PORTC,&Stub_PINC,&Stub_DDRD,&Stub_PORTD,&Stub_PIND
+};
+
+/*Port register accesses, and the register of the last one*/
+static unsigned long g_portAccesses=0;
+static volatile uint8_t *g_lastReg=NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Port access hook of the AVR stubs.
+ */
+volatile uint8_t *Stub_ioAccess(volatile uint8_t *reg)
+{
+	g_portAccesses++;
+	g_lastReg=reg;
+	return reg;
+}
+
+/*
+ * Load every port register with a different pattern, and reset the access counter.
+ */
+static void Test_loadRegs(uint8 seed)
+{
+	uint8 i;
+
+	for(i=0;i<TEST_NUM_OF_REGS;i++)
+	{
+		*g_regs[i]=(uint8)((seed*31U)+(i*0x5BU));
+	}
+	g_portAccesses=0;
+	g_lastReg=NULL_PTR;
+}
+
+/*
+ * Copy all the port registers.
+ */
+static void Test_saveRegs(uint8 *copy)
+{
+	uint8 i;
+
+	for(i=0;i<TEST_NUM_OF_REGS;i++)
+	{
+		copy[i]=*g_regs[i];
+	}
+}
+
+/*
+ * Check that the registers are equal to a copy.
+ */
+static boolean Test_regsEqual(const uint8 *copy)
+{
+	uint8 i;
+
+	for(i=0;i<TEST_NUM_OF_REGS;i++)
+	{
+		if(copy[i]!=*g_regs[i])
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*
+ * Check the registers left by a macro against the ones left by the function, and its register accesses.
+ * The last register accessed is checked if one is given.
+ */
+static void Test_checkMacro(const uint8 *expected,unsigned long accesses,volatile uint8_t *reg)
+{
+	TEST_CHECK(Test_regsEqual(expected));
+	TEST_CHECK_EQUAL(g_portAccesses,accesses);
+	TEST_CHECK((reg==NULL_PTR) || (g_lastReg==reg));
+}
+
+/*
+ * The direction and write macros of one pin against the functions, for both levels.
+ * The macros only take constant port and pin numbers, so each pin has its own expansion.
+ */
+#define TEST_PIN_WRITES(port,pin) \
+	do{ \
+		for(level=0;level<2;level++) \
+		{ \
+			Test_loadRegs((pin)+level); \
+			GPIO_setupPinDirection(port,pin,(level==0)?PIN_INPUT:PIN_OUTPUT); \
+			Test_saveRegs(expected); \
+			Test_loadRegs((pin)+level); \
+			GPIO_SETUP_PIN_DIRECTION(port,pin,(level==0)?PIN_INPUT:PIN_OUTPUT); \
+			Test_checkMacro(expected,1,g_regs[(port)*3]); \
+			Test_loadRegs((pin)+level); \
+			GPIO_writePin(port,pin,level); \
+			Test_saveRegs(expected); \
+			Test_loadRegs((pin)+level); \
+			GPIO_WRITE_PIN(port,pin,level); \
+			Test_checkMacro(expected,1,g_regs[((port)*3)+1]); \
+		} \
+	}while(0)
+
+/* The read macro of one pin against the function, for every seed of the registers */
+#define TEST_PIN_READS(port,pin) \
+	do{ \
+		for(seed=0;seed<8;seed++) \
+		{ \
+			Test_loadRegs(seed); \
+			value=GPIO_readPin(port,pin); \
+			g_portAccesses=0; \
+			TEST_CHECK_EQUAL(GPIO_READ_PIN(port,pin),value); \
+			TEST_CHECK_EQUAL(g_portAccesses,1); \
+			TEST_CHECK(g_lastReg==g_regs[((port)*3)+2]); \
+		} \
+	}while(0)
+
+/* The masked macros of one port against the functions, the port is read and written once */
+#define TEST_PORT_MASKED_WRITES(port) \
+	do{ \
+		for(seed=0;seed<16;seed++) \
+		{ \
+			mask=(uint8)(seed*0x37U); \
+			value=(uint8)(seed*0xA5U); \
+			Test_loadRegs(seed); \
+			GPIO_writeMasked(port,mask,value); \
+			Test_saveRegs(expected); \
+			Test_loadRegs(seed); \
+			GPIO_WRITE_MASKED(port,mask,value); \
+			Test_checkMacro(expected,2,g_regs[((port)*3)+1]); \
+			Test_loadRegs(seed); \
+			GPIO_configureMasked(port,mask,value); \
+			Test_saveRegs(expected); \
+			Test_loadRegs(seed); \
+			GPIO_CONFIGURE_MASKED(port,mask,value); \
+			Test_checkMacro(expected,2,g_regs[(port)*3]); \
+			TEST_CHECK(SREG&(1<<7)); \
+		} \
+	}while(0)
+
+/* Expand a pin check for every pin of a port, and for every pin of the four ports */
+#define TEST_FOR_PORT_PINS(check,port) \
+	check(port,PIN0_ID); check(port,PIN1_ID); check(port,PIN2_ID); check(port,PIN3_ID); \
+	check(port,PIN4_ID); check(port,PIN5_ID); check(port,PIN6_ID); check(port,PIN7_ID)
+#define TEST_FOR_ALL_PINS(check) \
+	TEST_FOR_PORT_PINS(check,PORTA_ID); TEST_FOR_PORT_PINS(check,PORTB_ID); \
+	TEST_FOR_PORT_PINS(check,PORTC_ID); TEST_FOR_PORT_PINS(check,PORTD_ID)
+
+/*
+ * The direction and write macros change the same bit as the functions, in one access of the right register.
+ */
+static void Test_pinWrites(void)
+{
+	uint8 expected[TEST_NUM_OF_REGS];
+	uint8 level;
+
+	TEST_FOR_ALL_PINS(TEST_PIN_WRITES);
+}
+
+/*
+ * The read macro returns the level the function returns, in one access of the PIN register.
+ */
+static void Test_pinReads(void)
+{
+	uint8 seed;
+	uint8 value;
+
+	TEST_FOR_ALL_PINS(TEST_PIN_READS);
+}
+
+/*
+ * The masked macros leave the same registers as the functions, the port is read and written once.
+ */
+static void Test_maskedWrites(void)
+{
+	uint8 expected[TEST_NUM_OF_REGS];
+	uint8 seed;
+	uint8 mask,value;
+
+	TEST_PORT_MASKED_WRITES(PORTA_ID);
+	TEST_PORT_MASKED_WRITES(PORTB_ID);
+	TEST_PORT_MASKED_WRITES(PORTC_ID);
+	TEST_PORT_MASKED_WRITES(PORTD_ID);
+}
+
+int main(void)
+{
+	SREG=(1<<7);
+
+	Test_pinWrites();
+	Test_pinReads();
+	Test_maskedWrites();
+
+	return TEST_RESULT("test_gpio");
+}
@@ -0,0 +1,420 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_keypad.c
+ *
+ * Description: Test of the keypad driver of the HMI ECU on a model of the 4x4 matrix.
+ *              The model drives the column pins from the pressed buttons and the driven
+ *              rows, and the INT0 gate pin from the columns. The system timer is the
+ *              millisecond model of the stubs, the external interrupt driver is replaced,
+ *              and scripted keystrokes with their contact bounce are played on the model clock.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "test_common.h"
+#include "keypad.h"
+#include "sys_timer_stub.h"
+#include "exti.h"
+#include <avr/io.h>
+
+#if((KEYPAD_ROW_PORT_ID != PORTA_ID) || (KEYPAD_COL_PORT_ID != PORTA_ID) || (KEYPAD_NUM_ROWS != 4) || \
+	(KEYPAD_NUM_COLS != 4) || (KEYPAD_BUTTON_PRESSED != LOGIC_LOW) || defined(STANDARD_KEYPAD))
+#error "The keypad model follows the board wiring: 4x4 keypad on PORTA, active low"
+#endif
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+#define MODEL_COLS_MASK         (0x0F<<KEYPAD_FIRST_COL_PIN_ID)
+#define MODEL_ROWS_MASK         (0x0F<<KEYPAD_FIRST_ROW_PIN_ID)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*One step of a keystroke script: the held buttons from the given millisecond of the script*/
+typedef struct{
+	unsigned long at_ms;
+	uint16 pressed;
+}Test_StepType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Buttons held on the matrix, bit n is the button (row*4)+col*/
+static uint16 g_pressed=0;
+
+/*INT0 line*/
+static Exti_CallBackType g_extiCallBack=NULL_PTR;
+static boolean g_extiEnabled=FALSE;
+
+/*Keystroke script played by the model clock*/
+static const Test_StepType *g_script=NULL_PTR;
+static uint8 g_scriptCount=0;
+static uint8 g_scriptNext=0;
+static unsigned long g_scriptStart=0;
+
+/*Port register accesses of the driver*/
+static unsigned long g_portAccesses=0;
+
+/*Value of each button as laid out on the keypad*/
+static const uint8 g_expectedKeys[16]={
+	7,   8,   9,   '%',
+	4,   5,   6,   '*',
+	1,   2,   3,   '-',
+	13,  0,   '=', '+'
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Output the column and gate levels: a pressed button pulls its column low if its row is driven low,
+ * the gate output is the AND of the columns.
+ */
+static void KeypadModel_update(void)
+{
+	uint8 row;
+	uint8 cols_low=0;
+
+	for(row=0;row<4;row++)
+	{
+		if((Stub_DDRA&(1<<(KEYPAD_FIRST_ROW_PIN_ID+row))) && !(Stub_PORTA&(1<<(KEYPAD_FIRST_ROW_PIN_ID+row))))
+		{
+			cols_low|=(g_pressed>>(row*4))&0x0F;
+		}
+	}
+	Stub_PINA=(Stub_PORTA&MODEL_ROWS_MASK)|(~(cols_low<<KEYPAD_FIRST_COL_PIN_ID)&MODEL_COLS_MASK);
+	if(cols_low!=0)
+	{
+		Stub_PIND&=~(1<<KEYPAD_INT_PIN_ID);
+	}
+	else
+	{
+		Stub_PIND|=(1<<KEYPAD_INT_PIN_ID);
+	}
+}
+
+/*
+ * Port access hook of the AVR stubs.
+ */
+volatile uint8_t *Stub_ioAccess(volatile uint8_t *reg)
+{
+	KeypadModel_update();
+	g_portAccesses++;
+	return reg;
+}
+
+/*
+ * External interrupt replacement, the falling edge of the gate is raised by Test_setButtons.
+ */
+void Exti_init(Exti_Line line,Exti_Sense sense,Exti_Dispatch dispatch,Exti_CallBackType a_ptr,void *context)
+{
+	g_extiCallBack=a_ptr;
+}
+
+void Exti_enable(Exti_Line line)
+{
+	g_extiEnabled=TRUE;
+}
+
+void Exti_disable(Exti_Line line)
+{
+	g_extiEnabled=FALSE;
+}
+
+/*
+ * Change the held buttons, a falling edge of the gate calls the INT0 call back if it's enabled.
+ */
+static void Test_setButtons(uint16 pressed)
+{
+	boolean gate_was_high;
+
+	KeypadModel_update();
+	gate_was_high=(Stub_PIND>>KEYPAD_INT_PIN_ID)&1;
+	g_pressed=pressed;
+	KeypadModel_update();
+	if(gate_was_high && !((Stub_PIND>>KEYPAD_INT_PIN_ID)&1) && g_extiEnabled)
+	{
+		(*g_extiCallBack)(NULL_PTR);
+	}
+}
+
+/*
+ * Play a keystroke script from now on, its steps are applied as the model clock runs.
+ */
+static void Test_playScript(const Test_StepType *script,uint8 count)
+{
+	g_script=script;
+	g_scriptCount=count;
+	g_scriptNext=0;
+	g_scriptStart=Stub_modelMs;
+}
+
+/*
+ * Run the model for the given milliseconds, the script steps are applied and the scanner
+ * call back runs on its period.
+ */
+static void Test_runMs(unsigned long ms)
+{
+	while(ms>0)
+	{
+		Stub_modelMs++;
+		ms--;
+		while((g_scriptNext<g_scriptCount) && ((Stub_modelMs-g_scriptStart)>=g_script[g_scriptNext].at_ms))
+		{
+			Test_setButtons(g_script[g_scriptNext].pressed);
+			g_scriptNext++;
+		}
+		Stub_runTimers();
+	}
+}
+
+/*
+ * Sleep replacement of KEYPAD_getPressedKey, the CPU sleeps for one millisecond.
+ */
+void SysTimer_idle(void)
+{
+	Test_runMs(1);
+}
+
+/*
+ * Every button is decoded to its keymap value, the scanner stops after the release.
+ */
+static void Test_decodeButtons(void)
+{
+	KEYPAD_EventType event;
+	uint8 button;
+
+	for(button=0;button<16;button++)
+	{
+		Test_setButtons(1<<button);
+		Test_runMs(100);
+		Test_setButtons(0);
+		Test_runMs(100);
+
+		TEST_CHECK(KEYPAD_getEvent(&event));
+		TEST_CHECK_EQUAL(event.key,g_expectedKeys[button]);
+		TEST_CHECK_EQUAL(event.kind,KEYPAD_PRESS);
+		TEST_CHECK(KEYPAD_getEvent(&event));
+		TEST_CHECK_EQUAL(event.kind,KEYPAD_RELEASE);
+		TEST_CHECK(KEYPAD_getEvent(&event)==FALSE);
+
+		/*The scanner is stopped and the rows are driven for the next press*/
+		TEST_CHECK(Stub_timerRunning(SYS_TIMER_KEYPAD)==FALSE);
+		TEST_CHECK(g_extiEnabled);
+		TEST_CHECK_EQUAL(Stub_DDRA&MODEL_ROWS_MASK,MODEL_ROWS_MASK);
+	}
+}
+
+/*
+ * Two buttons of the same column are told apart, only the scanned row is driven.
+ */
+static void Test_sameColumn(void)
+{
+	KEYPAD_EventType event;
+
+	Test_setButtons((1<<1)|(1<<9));
+	Test_runMs(100);
+	Test_setButtons(0);
+	Test_runMs(100);
+
+	TEST_CHECK(KEYPAD_getEvent(&event));
+	TEST_CHECK_EQUAL(event.key,8);
+	TEST_CHECK(KEYPAD_getEvent(&event));
+	TEST_CHECK_EQUAL(event.key,2);
+	KEYPAD_flush();
+}
+
+/*
+ * A scan of the matrix costs one direction write and one column read per row, counted as port accesses.
+ */
+static void Test_scanCost(void)
+{
+	Test_setButtons(1<<5);
+	Test_runMs(KEYPAD_SCAN_PERIOD_MS);
+	g_portAccesses=0;
+	Test_runMs(KEYPAD_SCAN_PERIOD_MS);
+
+	/*A masked direction write is a read and a write of DDRA, the column read is one access of PINA*/
+	TEST_CHECK_EQUAL(g_portAccesses,(4*3)+2);
+	printf("scan: %lu port accesses for the 4x4 matrix\n",g_portAccesses);
+
+	Test_setButtons(0);
+	Test_runMs(100);
+	KEYPAD_flush();
+}
+
+/*
+ * A press and a release with contact bounce on both edges give a single press and a single release.
+ */
+static void Test_bouncingPress(void)
+{
+	/*Button '5' bounces for 7 ms on the press and 9 ms on the release*/
+	static const Test_StepType script[]={
+		{0,1<<5},{1,0},{2,1<<5},{4,0},{5,1<<5},{7,0},{8,1<<5},
+		{300,0},{302,1<<5},{303,0},{306,1<<5},{307,0},{309,1<<5},{310,0}
+	};
+	KEYPAD_EventType event;
+
+	Test_playScript(script,sizeof(script)/sizeof(script[0]));
+	Test_runMs(400);
+
+	TEST_CHECK(KEYPAD_getEvent(&event));
+	TEST_CHECK_EQUAL(event.key,5);
+	TEST_CHECK_EQUAL(event.kind,KEYPAD_PRESS);
+	TEST_CHECK(KEYPAD_getEvent(&event));
+	TEST_CHECK_EQUAL(event.key,5);
+	TEST_CHECK_EQUAL(event.kind,KEYPAD_RELEASE);
+	TEST_CHECK(KEYPAD_getEvent(&event)==FALSE);
+	TEST_CHECK(Stub_timerRunning(SYS_TIMER_KEYPAD)==FALSE);
+	TEST_CHECK(g_extiEnabled);
+}
+
+/*
+ * Keys typed while the HMI is busy are kept in order, a fast typist's option and PIN are not lost.
+ */
+static void Test_typeAhead(void)
+{
+	/*'+' then "1234" and '=', each key held 60 ms with 40 ms between the keys and a bounce on each press*/
+	static const Test_StepType script[]={
+		{0,1<<15},{2,0},{3,1<<15},{60,0},
+		{100,1<<8},{102,0},{103,1<<8},{160,0},
+		{200,1<<9},{202,0},{203,1<<9},{260,0},
+		{300,1<<10},{302,0},{303,1<<10},{360,0},
+		{400,1<<4},{402,0},{403,1<<4},{460,0},
+		{500,1<<14},{502,0},{503,1<<14},{560,0}
+	};
+	static const uint8 typed[]={'+',1,2,3,4,'='};
+	uint8 i;
+
+	/*The HMI is busy for the whole script, like a wrong password screen, nothing reads the keys*/
+	Test_playScript(script,sizeof(script)/sizeof(script[0]));
+	Test_runMs(1000);
+
+	for(i=0;i<sizeof(typed);i++)
+	{
+		TEST_CHECK_EQUAL(KEYPAD_getPressedKey(),typed[i]);
+	}
+	TEST_CHECK(Stub_timerRunning(SYS_TIMER_KEYPAD)==FALSE);
+	KEYPAD_flush();
+}
+
+/*
+ * A key press blocks KEYPAD_getPressedKey in the idle sleep until it's typed, the release and
+ * repeat events are skipped.
+ */
+static void Test_blockingRead(void)
+{
+	static const Test_StepType script[]={{250,1<<2},{400,0}};
+	unsigned long start=Stub_modelMs;
+	KEYPAD_EventType event;
+
+	Test_playScript(script,sizeof(script)/sizeof(script[0]));
+	TEST_CHECK_EQUAL(KEYPAD_getPressedKey(),9);
+
+	/*The press is queued after KEYPAD_DEBOUNCE_SAMPLES scans*/
+	TEST_CHECK_EQUAL(Stub_modelMs-start,250UL+(KEYPAD_DEBOUNCE_SAMPLES*KEYPAD_SCAN_PERIOD_MS));
+
+	Test_runMs(200);
+	TEST_CHECK(KEYPAD_getEvent(&event));
+	TEST_CHECK_EQUAL(event.kind,KEYPAD_RELEASE);
+	TEST_CHECK(KEYPAD_getEvent(&event)==FALSE);
+}
+
+/*
+ * A held key repeats after the repeat delay, then on the repeat period, until it's released.
+ */
+static void Test_repeat(void)
+{
+	static const Test_StepType script[]={{0,1<<3},{1000,0}};
+	unsigned long times[8];
+	uint8 kinds[8];
+	uint8 count=0;
+	KEYPAD_EventType event;
+	unsigned long ms;
+
+	Test_playScript(script,sizeof(script)/sizeof(script[0]));
+	for(ms=0;ms<1200;ms++)
+	{
+		Test_runMs(1);
+		while(KEYPAD_getEvent(&event) && (count<8))
+		{
+			TEST_CHECK_EQUAL(event.key,'%');
+			times[count]=Stub_modelMs;
+			kinds[count]=event.kind;
+			count++;
+		}
+	}
+
+	/*Press, 4 repeats in the 1 s hold and the release*/
+	TEST_CHECK_EQUAL(count,6);
+	TEST_CHECK_EQUAL(kinds[0],KEYPAD_PRESS);
+	TEST_CHECK_EQUAL(kinds[1],KEYPAD_REPEAT);
+	TEST_CHECK_EQUAL(times[1]-times[0],(unsigned long)KEYPAD_REPEAT_DELAY_MS);
+	for(ms=2;ms<5;ms++)
+	{
+		TEST_CHECK_EQUAL(kinds[ms],KEYPAD_REPEAT);
+		TEST_CHECK_EQUAL(times[ms]-times[ms-1],(unsigned long)KEYPAD_REPEAT_PERIOD_MS);
+	}
+	TEST_CHECK_EQUAL(kinds[5],KEYPAD_RELEASE);
+}
+
+/*
+ * A full queue keeps its older events and drops the new ones, one slot is left empty.
+ * KEYPAD_flush discards what was typed ahead.
+ */
+static void Test_queueOverflow(void)
+{
+	KEYPAD_EventType event;
+	uint8 button;
+	uint8 count=0;
+
+	/*20 keystrokes are 40 events*/
+	for(button=0;button<20;button++)
+	{
+		Test_setButtons(1<<(button&0x0F));
+		Test_runMs(60);
+		Test_setButtons(0);
+		Test_runMs(60);
+	}
+
+	while(KEYPAD_getEvent(&event))
+	{
+		/*Press and release alternate, in the typing order*/
+		TEST_CHECK_EQUAL(event.key,g_expectedKeys[(count/2)&0x0F]);
+		TEST_CHECK_EQUAL(event.kind,((count&1)==0)?KEYPAD_PRESS:KEYPAD_RELEASE);
+		count++;
+	}
+	TEST_CHECK_EQUAL(count,KEYPAD_EVENT_QUEUE_SIZE-1);
+
+	Test_setButtons(1<<0);
+	Test_runMs(60);
+	Test_setButtons(0);
+	Test_runMs(60);
+	KEYPAD_flush();
+	TEST_CHECK(KEYPAD_getEvent(&event)==FALSE);
+}
+
+int main(void)
+{
+	SREG=(1<<7);
+	Stub_PORTA=MODEL_COLS_MASK; /*Pull ups of the columns*/
+	KEYPAD_init();
+
+	Test_decodeButtons();
+	Test_sameColumn();
+	Test_scanCost();
+	Test_bouncingPress();
+	Test_typeAhead();
+	Test_blockingRead();
+	Test_repeat();
+	Test_queueOverflow();
+
+	return TEST_RESULT("test_keypad");
+}
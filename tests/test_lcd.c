@@ -0,0 +1,540 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_lcd.c
+ *
+ * Description: Test of the LCD driver of the HMI ECU on a model of the HD44780 controller.
+ *              The model watches the port registers of the board wiring (8-bits bus, RW
+ *              connected), it executes the written instructions and answers the busy flag reads.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "test_common.h"
+#include "lcd.h"
+#include <avr/io.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if((LCD_DATA_BITS_MODE != 8) || (LCD_RW_CONNECTED != TRUE) || (LCD_DATA_PORT_ID != PORTC_ID) || \
+	(LCD_RS_PORT_ID != PORTB_ID) || (LCD_RW_PORT_ID != PORTB_ID) || (LCD_E_PORT_ID != PORTB_ID))
+#error "The LCD model follows the board wiring: 8-bits bus on PORTC, RS, RW and E on PORTB"
+#endif
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Timer2 compare ISR of the output queue, called by the test on every tick*/
+void TIMER2_COMP_vect(void);
+
+/*Execution times of the HD44780 at 270kHz*/
+#define MODEL_EXECUTION_TIME_US         37
+#define MODEL_CLEAR_EXECUTION_TIME_US   1520
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Model time in microseconds, it's advanced by the driver delays and by one CPU cycle per port access*/
+static unsigned long g_modelUs=0;
+
+/*Display data RAM and address counter of the controller*/
+static uint8 g_ddram[0x80];
+static uint8 g_address=0;
+
+/*The controller is busy until this time*/
+static unsigned long g_busyUntil=0;
+
+/*A disconnected LCD reads as busy forever, the pulled up bus reads ones*/
+static boolean g_disconnected=FALSE;
+
+/*Last seen level of the E pin*/
+static boolean g_lastE=FALSE;
+
+/*Counters of the bus activity*/
+static unsigned long g_instructions=0;
+static unsigned long g_characters=0;
+static unsigned long g_busyReads=0;
+static uint8 g_lastInstruction=0;
+
+/*Log of the executed bytes, the data bytes are marked by 0x100*/
+#define MODEL_LOG_DATA      0x100
+static uint16 g_log[200];
+static uint8 g_logCount=0;
+
+/*Protocol errors: a write while busy, or both sides driving the data bus*/
+static unsigned long g_busyViolations=0;
+static unsigned long g_contentions=0;
+
+/*Port register accesses of the driver*/
+static unsigned long g_portAccesses=0;
+
+/*TRUE while the queue ISR runs, and the delays called from it*/
+static boolean g_inIsr=FALSE;
+static unsigned long g_isrDelays=0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Execute one written byte, RS selects data or instruction.
+ */
+static void LcdModel_execute(boolean rs,uint8 value)
+{
+	unsigned long execution_time=MODEL_EXECUTION_TIME_US;
+
+	if(g_modelUs<g_busyUntil)
+	{
+		g_busyViolations++;
+	}
+
+	if(g_logCount<(sizeof(g_log)/sizeof(g_log[0])))
+	{
+		g_log[g_logCount]=(rs?MODEL_LOG_DATA:0)|value;
+		g_logCount++;
+	}
+
+	if(rs)
+	{
+		g_ddram[g_address&0x7F]=value;
+		g_characters++;
+		if(g_address==0x27)
+		{
+			g_address=0x40;
+		}
+		else if(g_address==0x67)
+		{
+			g_address=0x00;
+		}
+		else
+		{
+			g_address++;
+		}
+	}
+	else
+	{
+		g_instructions++;
+		g_lastInstruction=value;
+		if(value&0x80)
+		{
+			g_address=value&0x7F;
+		}
+		else if((value==LCD_CLEAR_COMMAND) || (value==LCD_GO_TO_HOME))
+		{
+			if(value==LCD_CLEAR_COMMAND)
+			{
+				memset(g_ddram,' ',sizeof(g_ddram));
+			}
+			g_address=0;
+			execution_time=MODEL_CLEAR_EXECUTION_TIME_US;
+		}
+		else
+		{
+			/*Function set, display control and entry mode keep the address*/
+		}
+	}
+	g_busyUntil=g_modelUs+execution_time;
+}
+
+/*
+ * Follow the pins since the last port access: the E falling edge latches a write,
+ * the E rising edge with RW high outputs the busy flag and the address counter.
+ */
+static void LcdModel_sync(void)
+{
+	boolean e=(Stub_PORTB>>LCD_E_PIN_ID)&1;
+	boolean rw=(Stub_PORTB>>LCD_RW_PIN_ID)&1;
+	boolean rs=(Stub_PORTB>>LCD_RS_PIN_ID)&1;
+
+	if(rw && (Stub_DDRC!=0))
+	{
+		g_contentions++;
+	}
+
+	if(e && !g_lastE && rw)
+	{
+		g_busyReads++;
+		if(g_disconnected)
+		{
+			Stub_PINC=0xFF;
+		}
+		else
+		{
+			Stub_PINC=((g_modelUs<g_busyUntil)?(1<<LCD_BUSY_FLAG_BIT):0)|g_address;
+		}
+	}
+	else if(!e && g_lastE && !rw && !g_disconnected)
+	{
+		LcdModel_execute(rs,Stub_PORTC);
+	}
+	g_lastE=e;
+}
+
+/*
+ * Port access hook of the AVR stubs, an access takes at least one CPU cycle (1us at 1MHz).
+ */
+volatile uint8_t *Stub_ioAccess(volatile uint8_t *reg)
+{
+	LcdModel_sync();
+	g_modelUs++;
+	g_portAccesses++;
+	return reg;
+}
+
+/*
+ * Delay functions, the model time moves on by the delay.
+ */
+void _delay_us(double us)
+{
+	LcdModel_sync();
+	g_modelUs+=(unsigned long)us;
+	g_isrDelays+=g_inIsr;
+}
+
+void _delay_ms(double ms)
+{
+	LcdModel_sync();
+	g_modelUs+=(unsigned long)(ms*1000);
+	g_isrDelays+=g_inIsr;
+}
+
+/*
+ * itoa of the AVR libc, used by LCD_intgerToString.
+ */
+char *itoa(int value,char *str,int radix)
+{
+	sprintf(str,"%d",value);
+	return str;
+}
+
+/*
+ * Return TRUE if the given row of the screen shows the string.
+ */
+static boolean Test_rowShows(uint8 row,const char *str)
+{
+	uint8 base=(row==0)?0x00:0x40;
+
+	return (memcmp(&g_ddram[base],str,strlen(str))==0)?TRUE:FALSE;
+}
+
+/*
+ * Run one Timer2 tick of the output queue, the model time moves on by the tick.
+ */
+static void Test_queueTick(void)
+{
+	g_modelUs+=LCD_QUEUE_TICK_US;
+	g_inIsr=TRUE;
+	TIMER2_COMP_vect();
+	LcdModel_sync();
+	g_inIsr=FALSE;
+}
+
+/*
+ * Run the Timer2 ticks until the output queue is empty.
+ */
+static void Test_drainQueue(void)
+{
+	uint16 ticks=0;
+
+	while((LCD_isIdle()==FALSE) && (ticks<10000))
+	{
+		Test_queueTick();
+		ticks++;
+	}
+	TEST_CHECK(LCD_isIdle());
+	TEST_CHECK_EQUAL(g_isrDelays,0);
+}
+
+/*
+ * Reset the bus counters and the log.
+ */
+static void Test_resetCounters(void)
+{
+	LcdModel_sync();
+	g_logCount=0;
+	g_instructions=0;
+	g_characters=0;
+	g_busyReads=0;
+	g_busyViolations=0;
+	g_contentions=0;
+}
+
+/*
+ * The initialization sets the 8-bits mode, turns the cursor off and clears the screen.
+ */
+static void Test_init(void)
+{
+	memset(g_ddram,'?',sizeof(g_ddram));
+	LCD_init();
+	LcdModel_sync();
+
+	TEST_CHECK_EQUAL(g_instructions,3);
+	TEST_CHECK_EQUAL(g_lastInstruction,LCD_CLEAR_COMMAND);
+	TEST_CHECK(Test_rowShows(0,"                "));
+	TEST_CHECK(Test_rowShows(1,"                "));
+	TEST_CHECK_EQUAL(g_busyViolations,0);
+	TEST_CHECK_EQUAL(g_contentions,0);
+}
+
+/*
+ * The direct writes wait for the busy flag, a clear is followed by its long execution time.
+ */
+static void Test_directWrites(void)
+{
+	unsigned long start;
+
+	Test_resetCounters();
+	LCD_clearScreen();
+	start=g_modelUs;
+	LCD_moveCursor(1,3);
+	LCD_displayString("Door");
+	LcdModel_sync();
+	TEST_CHECK(g_modelUs-start>=MODEL_CLEAR_EXECUTION_TIME_US);
+	TEST_CHECK(Test_rowShows(1,"   Door"));
+	TEST_CHECK_EQUAL(g_busyViolations,0);
+	TEST_CHECK_EQUAL(g_contentions,0);
+
+	/*The cursor is already after "Door", so no cursor move is sent*/
+	Test_resetCounters();
+	LCD_moveCursor(1,7);
+	LCD_intgerToString(42);
+	LcdModel_sync();
+	TEST_CHECK_EQUAL(g_instructions,0);
+	TEST_CHECK(Test_rowShows(1,"   Door42"));
+}
+
+/*
+ * Wait time of a full screen written with the direct functions: 2 cursor moves and 32 characters.
+ * The CPU time of the driver is only modelled as one cycle per port access.
+ */
+static void Test_screenWaitTime(void)
+{
+	unsigned long start;
+
+	Test_resetCounters();
+	start=g_modelUs;
+	LCD_moveCursor(0,0);
+	LCD_displayString("0123456789ABCDEF");
+	LCD_moveCursor(1,0);
+	LCD_displayString("FEDCBA9876543210");
+	LcdModel_sync();
+	TEST_CHECK(Test_rowShows(0,"0123456789ABCDEF"));
+	TEST_CHECK(Test_rowShows(1,"FEDCBA9876543210"));
+	TEST_CHECK_EQUAL(g_instructions+g_characters,34);
+	TEST_CHECK_EQUAL(g_busyViolations,0);
+
+	/*Each byte waits about its execution time, far from the millisecond per strobe of the old driver*/
+	TEST_CHECK(g_modelUs-start<34UL*2UL*MODEL_EXECUTION_TIME_US);
+	printf("full screen: %lu us, %lu busy flag reads\n",g_modelUs-start,g_busyReads);
+}
+
+/*
+ * A missing LCD reads busy forever, every write gives up after the poll limit.
+ */
+static void Test_disconnected(void)
+{
+	Test_resetCounters();
+	g_disconnected=TRUE;
+	LCD_displayCharacter('X');
+	LcdModel_sync();
+	TEST_CHECK_EQUAL(g_busyReads,LCD_BUSY_FLAG_TIMEOUT);
+	TEST_CHECK_EQUAL(g_contentions,0);
+	g_disconnected=FALSE;
+}
+
+/*
+ * A flush sends only the changed cells, one cursor move per run of contiguous changes, in screen order.
+ */
+static void Test_frameBufferFlush(void)
+{
+	static const uint16 star_run[]={0x80|0x45,MODEL_LOG_DATA|'*',MODEL_LOG_DATA|'*'};
+	static const uint16 two_runs[]={0x80|0x02,MODEL_LOG_DATA|'c',0x80|0x4F,MODEL_LOG_DATA|'!'};
+
+	LCD_clearScreen();
+	LCD_fbClear();
+	LCD_fbWrite(0,0,"+ : Open Door");
+	LCD_fbWrite(1,0,"- : Change Pass");
+	Test_resetCounters();
+	LCD_fbFlush();
+	Test_drainQueue();
+	TEST_CHECK(Test_rowShows(0,"+ : Open Door   "));
+	TEST_CHECK(Test_rowShows(1,"- : Change Pass "));
+	TEST_CHECK_EQUAL(g_busyViolations,0);
+	TEST_CHECK_EQUAL(g_contentions,0);
+
+	/*
+	 * The spaces are already on the cleared screen, every other run costs one cursor move,
+	 * except the first one at the address left by the clear
+	 */
+	TEST_CHECK_EQUAL(g_log[0],MODEL_LOG_DATA|'+');
+	TEST_CHECK_EQUAL(g_characters,22);
+	TEST_CHECK_EQUAL(g_instructions,7);
+
+	/*Nothing changed, nothing is sent*/
+	Test_resetCounters();
+	LCD_fbFlush();
+	Test_drainQueue();
+	TEST_CHECK_EQUAL(g_logCount,0);
+
+	/*One run of two changed cells*/
+	Test_resetCounters();
+	LCD_fbWrite(1,5,"**");
+	LCD_fbFlush();
+	Test_drainQueue();
+	TEST_CHECK_EQUAL(g_logCount,3);
+	TEST_CHECK(memcmp(g_log,star_run,sizeof(star_run))==0);
+
+	/*Two runs, flushed in row order*/
+	Test_resetCounters();
+	LCD_fbWrite(1,15,"!");
+	LCD_fbWrite(0,2,"c");
+	LCD_fbFlush();
+	Test_drainQueue();
+	TEST_CHECK_EQUAL(g_logCount,4);
+	TEST_CHECK(memcmp(g_log,two_runs,sizeof(two_runs))==0);
+	TEST_CHECK(Test_rowShows(0,"+ c Open Door   "));
+	TEST_CHECK(Test_rowShows(1,"- : C**nge Pass!"));
+
+	/*The characters beyond the end of the row and the rows out of range are dropped*/
+	Test_resetCounters();
+	LCD_fbWrite(0,14,"xyz");
+	LCD_fbWrite(LCD_ROWS,0,"row");
+	LCD_fbFlush();
+	Test_drainQueue();
+	TEST_CHECK_EQUAL(g_characters,2);
+	TEST_CHECK(Test_rowShows(0,"+ c Open Door xy"));
+	TEST_CHECK(Test_rowShows(1,"- : C**nge Pass!"));
+
+	/*A clear screen re-synchronizes the copy, the whole frame is sent again*/
+	Test_resetCounters();
+	LCD_clearScreen();
+	LCD_fbFlush();
+	Test_drainQueue();
+	TEST_CHECK(Test_rowShows(0,"+ c Open Door xy"));
+	TEST_CHECK(Test_rowShows(1,"- : C**nge Pass!"));
+	TEST_CHECK_EQUAL(g_busyViolations,0);
+}
+
+/*
+ * The queue ISR reads the busy flag once and leaves a busy LCD for the next tick, without any delay.
+ */
+static void Test_queueIsr(void)
+{
+	LCD_fbWrite(0,0,"Q");
+	LCD_fbFlush();
+	LcdModel_sync();
+
+	unsigned long busy_tick_accesses;
+
+	/*The LCD is kept busy for two ticks, each one is a single read*/
+	Test_resetCounters();
+	g_isrDelays=0;
+	g_busyUntil=g_modelUs+(2UL*LCD_QUEUE_TICK_US)+(LCD_QUEUE_TICK_US/2);
+	Test_queueTick();
+	g_portAccesses=0;
+	Test_queueTick();
+	busy_tick_accesses=g_portAccesses;
+	TEST_CHECK_EQUAL(g_busyReads,2);
+	TEST_CHECK_EQUAL(g_logCount,0);
+	TEST_CHECK_EQUAL(Stub_DDRC,0xFF);
+	TEST_CHECK_EQUAL(g_contentions,0);
+	TEST_CHECK_EQUAL(g_isrDelays,0);
+
+	/*
+	 * The LCD is ready on the next tick, one entry is written. Beyond the busy flag read it costs
+	 * four port accesses: RS, E high, the data port write and E low.
+	 */
+	g_portAccesses=0;
+	Test_queueTick();
+	TEST_CHECK_EQUAL(g_busyReads,3);
+	TEST_CHECK_EQUAL(g_logCount,1);
+	TEST_CHECK_EQUAL(g_portAccesses-busy_tick_accesses,4);
+	printf("queue tick: %lu port accesses for the busy flag read, %lu to write a byte\n",
+			busy_tick_accesses,g_portAccesses);
+
+	Test_drainQueue();
+	TEST_CHECK(Test_rowShows(0,"Q"));
+	TEST_CHECK_EQUAL(g_busyViolations,0);
+}
+
+/*
+ * The tracked address counter drops the cursor moves to where the cursor already is,
+ * and a move is always sent when the address isn't known.
+ */
+static void Test_cursorTracking(void)
+{
+	uint8 i;
+
+	/*Password echo: the first star needs a move, the next ones follow the auto increment*/
+	LCD_clearScreen();
+	LCD_fbClear();
+	LCD_fbWrite(0,0,"Plz Enter Pass:");
+	LCD_fbFlush();
+	Test_drainQueue();
+	for(i=0;i<5;i++)
+	{
+		Test_resetCounters();
+		LCD_fbWrite(1,i,"*");
+		LCD_fbFlush();
+		Test_drainQueue();
+		TEST_CHECK_EQUAL(g_logCount,(i==0)?2:1);
+	}
+	TEST_CHECK(Test_rowShows(1,"*****"));
+
+	/*A queued string continues a direct one without a move*/
+	Test_resetCounters();
+	LCD_moveCursor(1,8);
+	LCD_displayString("ab");
+	LCD_displayStringRowColumn(1,10,"cd");
+	Test_drainQueue();
+	TEST_CHECK_EQUAL(g_instructions,1);
+	TEST_CHECK(Test_rowShows(1,"*****   abcd"));
+
+	/*The end of the first line (0x27) wraps to the second line (0x40)*/
+	Test_resetCounters();
+	LCD_displayStringRowColumn(0,0x27,"AB");
+	LCD_displayStringRowColumn(1,1,"C");
+	Test_drainQueue();
+	TEST_CHECK_EQUAL(g_instructions,1);
+	TEST_CHECK_EQUAL(g_ddram[0x27],'A');
+	TEST_CHECK(Test_rowShows(1,"BC"));
+
+	/*The entry mode may change the direction, the address isn't known until the next move*/
+	Test_resetCounters();
+	LCD_sendCommand(0x06);
+	LCD_moveCursor(1,2);
+	LCD_displayCharacter('D');
+	LcdModel_sync();
+	TEST_CHECK_EQUAL(g_instructions,2);
+	TEST_CHECK(Test_rowShows(1,"BCD"));
+
+	/*The clear screen puts the cursor back home*/
+	Test_resetCounters();
+	LCD_clearScreen();
+	LCD_moveCursor(0,0);
+	LCD_displayCharacter('H');
+	LcdModel_sync();
+	TEST_CHECK_EQUAL(g_instructions,1);
+	TEST_CHECK(Test_rowShows(0,"H "));
+	TEST_CHECK_EQUAL(g_busyViolations,0);
+	TEST_CHECK_EQUAL(g_contentions,0);
+}
+
+int main(void)
+{
+	SREG=(1<<7);
+
+	Test_init();
+	Test_directWrites();
+	Test_screenWaitTime();
+	Test_disconnected();
+	Test_frameBufferFlush();
+	Test_queueIsr();
+	Test_cursorTracking();
+
+	return TEST_RESULT("test_lcd");
+}
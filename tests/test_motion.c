@@ -0,0 +1,258 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_motion.c
+ *
+ * Description: Test of the trapezoidal motion profile of the Control ECU.
+ *              Motion_dutyAt is checked phase by phase, then a travel is run on a model of
+ *              the motor output: the motion system timer is a tick counter and the duty
+ *              written to the PWM driver is recorded on every tick.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "test_common.h"
+#include "motion.h"
+#include "pwm.h"
+#include "CONTROL_ECU.h"
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Door profile of the Control ECU*/
+static const Motion_ProfileType g_doorProfile={
+		DOOR_MOTION_TIME_MS,DOOR_ACCEL_TIME_MS,DOOR_DECEL_TIME_MS,DOOR_APPROACH_TIME_MS,DOOR_OVERRUN_TIME_MS,
+		DOOR_CRUISE_DUTY,DOOR_APPROACH_DUTY
+};
+
+/*Motion system timer*/
+static SysTimer_CallBackType g_timerCallBack=NULL_PTR;
+static boolean g_timerRunning=FALSE;
+
+/*Motor output: direction and duty driven*/
+static DcMotor_State g_motorState=STOP;
+static uint8 g_motorDuty=0;
+
+/*Calls of the done call back*/
+static uint8 g_doneCount=0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * System timer replacement, the travel runs one tick per call of Test_tick.
+ */
+void SysTimer_start(SysTimer_Id id,uint32 delay,uint32 period,SysTimer_CallBackType a_ptr,void *context)
+{
+	TEST_CHECK_EQUAL(period,SYS_TIMER_MS_TO_TICKS(MOTION_TICK_MS));
+	g_timerCallBack=a_ptr;
+	g_timerRunning=TRUE;
+}
+
+void SysTimer_stop(SysTimer_Id id)
+{
+	g_timerRunning=FALSE;
+}
+
+/*
+ * Motor driver replacements, they record the motor output.
+ */
+void DcMotor_drive(DcMotor_State state,uint8 duty)
+{
+	g_motorState=state;
+	g_motorDuty=duty;
+}
+
+void PWM_Timer0_setDuty(uint8 duty)
+{
+	g_motorDuty=duty;
+}
+
+/*
+ * Done call back of the travels.
+ */
+static void Test_doneCallBack(void *context)
+{
+	g_doneCount++;
+}
+
+/*
+ * Run one tick of the motion system timer.
+ */
+static void Test_tick(void)
+{
+	if(g_timerRunning)
+	{
+		(*g_timerCallBack)(NULL_PTR);
+	}
+}
+
+/*
+ * The duty of the door profile follows its five phases.
+ */
+static void Test_phases(void)
+{
+	const Motion_ProfileType *p=&g_doorProfile;
+	uint16 decel_start=p->travel_time_ms-p->approach_time_ms-p->decel_time_ms;
+	uint16 t;
+	uint8 last=0;
+
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,0),0);
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,p->accel_time_ms/2),p->cruise_duty/2);
+	for(t=0;t<p->accel_time_ms;t++)
+	{
+		TEST_CHECK(Motion_dutyAt(p,t)>=last);
+		last=Motion_dutyAt(p,t);
+	}
+	TEST_CHECK(last<p->cruise_duty);
+
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,p->accel_time_ms),p->cruise_duty);
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,decel_start-1),p->cruise_duty);
+
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,decel_start),p->cruise_duty);
+	/*The interpolation is truncated towards the start duty*/
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,decel_start+(p->decel_time_ms/2)),(p->cruise_duty+p->approach_duty+1)/2);
+	last=p->cruise_duty;
+	for(t=decel_start;t<(decel_start+p->decel_time_ms);t++)
+	{
+		TEST_CHECK(Motion_dutyAt(p,t)<=last);
+		TEST_CHECK(Motion_dutyAt(p,t)>=p->approach_duty);
+		last=Motion_dutyAt(p,t);
+	}
+
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,decel_start+p->decel_time_ms),p->approach_duty);
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,p->travel_time_ms-1),p->approach_duty);
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,p->travel_time_ms),p->approach_duty);
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,p->travel_time_ms+p->overrun_time_ms-1),p->approach_duty);
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,p->travel_time_ms+p->overrun_time_ms),0);
+	TEST_CHECK_EQUAL(Motion_dutyAt(p,0xFFFF),0);
+}
+
+/*
+ * A travel too short for a cruise follows the lower of the two ramps, a triangle without a step.
+ */
+static void Test_triangle(void)
+{
+	/*The acceleration to 200 ends at 2000 ms, the deceleration to 50 starts at 1500 ms*/
+	static const Motion_ProfileType p={3000,2000,1000,500,0,200,50};
+	uint8 peak=0;
+	uint8 duty,last=0;
+	uint16 t;
+
+	for(t=0;t<p.travel_time_ms;t+=MOTION_TICK_MS)
+	{
+		/*Steps of the ramps: 1 per tick accelerating, 1.5 per tick decelerating*/
+		duty=Motion_dutyAt(&p,t);
+		TEST_CHECK(abs((int)duty-(int)last)<=2);
+		if(t<p.accel_time_ms)
+		{
+			TEST_CHECK(duty<=(t/10));
+		}
+		if(duty>peak)
+		{
+			peak=duty;
+		}
+		last=duty;
+	}
+
+	/*The ramps cross at 1700 ms, at the duty 170*/
+	TEST_CHECK_EQUAL(peak,170);
+	TEST_CHECK_EQUAL(Motion_dutyAt(&p,1700),170);
+	TEST_CHECK_EQUAL(Motion_dutyAt(&p,1500),150);
+	TEST_CHECK_EQUAL(Motion_dutyAt(&p,2500),p.approach_duty);
+}
+
+/*
+ * A travel writes the profile duty on every tick, then stops the motor and calls the done call back
+ * once at the end of the overrun time.
+ */
+static void Test_travel(void)
+{
+	const Motion_ProfileType *p=&g_doorProfile;
+	uint16 elapsed=0;
+
+	g_doneCount=0;
+	Motion_start(CW,p,Test_doneCallBack,NULL_PTR);
+	TEST_CHECK_EQUAL(g_motorState,CW);
+	TEST_CHECK_EQUAL(g_motorDuty,0);
+	TEST_CHECK(Motion_isRunning());
+
+	while(g_timerRunning && (elapsed<0xF000U))
+	{
+		Test_tick();
+		elapsed+=MOTION_TICK_MS;
+		if(g_timerRunning)
+		{
+			TEST_CHECK_EQUAL(g_motorDuty,Motion_dutyAt(p,elapsed));
+			TEST_CHECK_EQUAL(Motion_getDirection(),CW);
+		}
+	}
+
+	TEST_CHECK_EQUAL(elapsed,p->travel_time_ms+p->overrun_time_ms);
+	TEST_CHECK_EQUAL(g_doneCount,1);
+	TEST_CHECK_EQUAL(g_motorState,STOP);
+	TEST_CHECK(Motion_isRunning()==FALSE);
+	TEST_CHECK_EQUAL(Motion_getDirection(),STOP);
+
+	/*Ending a finished travel again does nothing*/
+	Motion_endTravel();
+	TEST_CHECK_EQUAL(g_doneCount,1);
+}
+
+/*
+ * An approach request skips the rest of the cruise, during the acceleration it waits for its end.
+ * The end position ends the travel at once.
+ */
+static void Test_approach(void)
+{
+	const Motion_ProfileType *p=&g_doorProfile;
+	uint16 decel_start=p->travel_time_ms-p->approach_time_ms-p->decel_time_ms;
+	uint16 elapsed=0;
+
+	g_doneCount=0;
+	Motion_start(CCW,p,Test_doneCallBack,NULL_PTR);
+	Motion_approach();
+	while(elapsed<p->accel_time_ms-MOTION_TICK_MS)
+	{
+		Test_tick();
+		elapsed+=MOTION_TICK_MS;
+		TEST_CHECK_EQUAL(g_motorDuty,Motion_dutyAt(p,elapsed));
+	}
+
+	/*The acceleration ends, the deceleration starts on the same tick*/
+	Test_tick();
+	TEST_CHECK_EQUAL(g_motorDuty,Motion_dutyAt(p,decel_start));
+	Test_tick();
+	TEST_CHECK_EQUAL(g_motorDuty,Motion_dutyAt(p,decel_start+MOTION_TICK_MS));
+	TEST_CHECK(g_motorDuty<p->cruise_duty);
+
+	Motion_endTravel();
+	TEST_CHECK_EQUAL(g_doneCount,1);
+	TEST_CHECK_EQUAL(g_motorState,STOP);
+	TEST_CHECK(g_timerRunning==FALSE);
+
+	/*A stopped travel doesn't call the done call back*/
+	Motion_start(CW,p,Test_doneCallBack,NULL_PTR);
+	Motion_stop();
+	TEST_CHECK_EQUAL(g_doneCount,1);
+	TEST_CHECK_EQUAL(g_motorState,STOP);
+	TEST_CHECK(Motion_isRunning()==FALSE);
+}
+
+int main(void)
+{
+	SREG=(1<<7);
+
+	Test_phases();
+	Test_triangle();
+	Test_travel();
+	Test_approach();
+
+	return TEST_RESULT("test_motion");
+}
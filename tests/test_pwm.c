@@ -0,0 +1,145 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_pwm.c
+ *
+ * Description: Test of the duty cycle ramps of the PWM Timer0 driver of the Control ECU.
+ *              The ramp system timer is replaced by a tick counter, OCR0 is checked after each tick.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "test_common.h"
+#include "pwm.h"
+#include "sys_timer.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Ramp system timer*/
+static SysTimer_CallBackType g_timerCallBack=NULL_PTR;
+static boolean g_timerRunning=FALSE;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * System timer replacement, the ramp runs one step per call of Test_tick.
+ */
+void SysTimer_start(SysTimer_Id id,uint32 delay,uint32 period,SysTimer_CallBackType a_ptr,void *context)
+{
+	TEST_CHECK_EQUAL(delay,SYS_TIMER_MS_TO_TICKS(PWM_RAMP_TICK_MS));
+	TEST_CHECK_EQUAL(period,SYS_TIMER_MS_TO_TICKS(PWM_RAMP_TICK_MS));
+	g_timerCallBack=a_ptr;
+	g_timerRunning=TRUE;
+}
+
+void SysTimer_stop(SysTimer_Id id)
+{
+	g_timerRunning=FALSE;
+}
+
+/*
+ * Run the ramp until it stops, the duty must move monotonically to the target.
+ * Returns the number of ticks it took.
+ */
+static uint16 Test_runRamp(uint8 target)
+{
+	uint16 ticks=0;
+	uint8 last=OCR0;
+
+	while(g_timerRunning && (ticks<10000U))
+	{
+		(*g_timerCallBack)(NULL_PTR);
+		ticks++;
+		if(target>=last)
+		{
+			TEST_CHECK((OCR0>=last) && (OCR0<=target));
+		}
+		else
+		{
+			TEST_CHECK((OCR0<=last) && (OCR0>=target));
+		}
+		last=OCR0;
+	}
+	TEST_CHECK_EQUAL(OCR0,target);
+
+	return ticks;
+}
+
+/*
+ * A ramp shorter than two ticks sets the target at once, whatever the duty distance.
+ */
+static void Test_shortRamps(void)
+{
+	PWM_Timer0_setDuty(0);
+	PWM_Timer0_ramp(PWM_MAX_DUTY,PWM_RAMP_TICK_MS);
+	TEST_CHECK_EQUAL(OCR0,PWM_MAX_DUTY);
+	TEST_CHECK(g_timerRunning==FALSE);
+
+	PWM_Timer0_ramp(0,(2*PWM_RAMP_TICK_MS)-1);
+	TEST_CHECK_EQUAL(OCR0,0);
+	TEST_CHECK(g_timerRunning==FALSE);
+
+	PWM_Timer0_ramp(128,0);
+	TEST_CHECK_EQUAL(OCR0,128);
+	TEST_CHECK(g_timerRunning==FALSE);
+}
+
+/*
+ * A full scale ramp up and down takes its number of ticks, from the two tick ramp to the longest one.
+ */
+static void Test_fullScaleRamps(void)
+{
+	static const uint16 times_ms[]={2*PWM_RAMP_TICK_MS,3*PWM_RAMP_TICK_MS,500,2550,60000U};
+	uint8 i;
+
+	for(i=0;i<(sizeof(times_ms)/sizeof(times_ms[0]));i++)
+	{
+		PWM_Timer0_setDuty(0);
+		PWM_Timer0_ramp(PWM_MAX_DUTY,times_ms[i]);
+		TEST_CHECK_EQUAL(Test_runRamp(PWM_MAX_DUTY),times_ms[i]/PWM_RAMP_TICK_MS);
+
+		PWM_Timer0_ramp(0,times_ms[i]);
+		TEST_CHECK_EQUAL(Test_runRamp(0),times_ms[i]/PWM_RAMP_TICK_MS);
+	}
+}
+
+/*
+ * A ramp replacing a running one starts from the duty reached, without a jump.
+ */
+static void Test_replacedRamp(void)
+{
+	uint8 reached;
+	uint8 i;
+
+	PWM_Timer0_setDuty(0);
+	PWM_Timer0_ramp(200,1000);
+	for(i=0;i<50;i++)
+	{
+		(*g_timerCallBack)(NULL_PTR);
+	}
+	reached=OCR0;
+	TEST_CHECK((reached>90) && (reached<110));
+
+	PWM_Timer0_ramp(20,500);
+	TEST_CHECK_EQUAL(OCR0,reached);
+	TEST_CHECK_EQUAL(Test_runRamp(20),50);
+}
+
+int main(void)
+{
+	SREG=(1<<7);
+
+	Test_shortRamps();
+	Test_fullScaleRamps();
+	Test_replacedRamp();
+
+	return TEST_RESULT("test_pwm");
+}
@@ -0,0 +1,281 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test_sys_timer.c
+ *
+ * Description: Test of the tickless system timer service on a model of Timer1.
+ *              It's built once against each ECU, it checks the expiry times and
+ *              counts the Timer1 interrupts (CPU wake ups) over one hour.
+ *
+ * Author: Mohamed Gad
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "test_common.h"
+#include "sys_timer.h"
+#include "timestamp.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+/*Timer1 ticks in one hour of the model*/
+#define TEST_HOUR_TICKS             SYS_TIMER_MS_TO_TICKS(3600000UL)
+
+/*Timer1 ISRs, called by the model*/
+void TIMER1_COMPA_vect(void);
+void TIMER1_OVF_vect(void);
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*Chain of one shot timers, each expiry starts the next delay like the door and lockout sequences*/
+typedef struct{
+	SysTimer_Id id;
+	const uint32 *delays_ms;
+	uint8 count;
+	uint8 next;
+}Test_ChainType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*Ticks run by the model since the start, and the tick the sleeping CPU wakes up at the latest*/
+static uint32 g_modelTicks=0;
+static uint32 g_modelEnd=0;
+
+/*Timer1 interrupts taken by the model, each one wakes the CPU up*/
+static uint32 g_wakeups=0;
+
+/*Timestamps of the last expiries, and their number*/
+static uint32 g_expiryTime[64];
+static uint8 g_expiryCount=0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Run Timer1 for up to "ticks" counts, it stops at the first enabled interrupt and runs its ISR.
+ * Returns TRUE if an ISR ran. The compare match A has priority over the overflow, like the vector table.
+ */
+static boolean Timer1Model_run(uint32 ticks)
+{
+	uint32 to_overflow=0x10000UL-TCNT1;
+	uint32 to_compare=(uint16)(OCR1A-TCNT1);
+	uint32 step=ticks;
+	uint8 pending=0;
+	uint8 sreg_value;
+
+	if(to_compare==0)
+	{
+		/*The compare value was reached already, the next match is a full period away*/
+		to_compare=0x10000UL;
+	}
+	if((TIMSK&(1<<OCIE1A)) && (to_compare<=step))
+	{
+		step=to_compare;
+	}
+	if((TIMSK&(1<<TOIE1)) && (to_overflow<=step))
+	{
+		step=to_overflow;
+	}
+
+	TCNT1=(uint16)(TCNT1+step);
+	g_modelTicks+=step;
+	if(step==to_overflow)
+	{
+		pending|=(1<<TOV1);
+	}
+	if(step==to_compare)
+	{
+		pending|=(1<<OCF1A);
+	}
+	pending&=TIMSK;
+
+	/*TIFR shows the flags of both events, so Timestamp_now sees an overflow behind a compare match*/
+	TIFR=pending;
+	sreg_value=SREG;
+	if(pending&(1<<OCF1A))
+	{
+		SREG&=~(1<<7);
+		TIFR&=~(1<<OCF1A);
+		TIMER1_COMPA_vect();
+		g_wakeups++;
+	}
+	if(pending&(1<<TOV1))
+	{
+		SREG&=~(1<<7);
+		TIFR&=~(1<<TOV1);
+		TIMER1_OVF_vect();
+		g_wakeups++;
+	}
+	SREG=sreg_value;
+	TIFR=0;
+
+	return (pending!=0)?TRUE:FALSE;
+}
+
+/*
+ * Sleep hook of the AVR stubs, the CPU sleeps until the next Timer1 interrupt or the end of the run.
+ */
+void Stub_sleepCpu(void)
+{
+	while((g_modelTicks<g_modelEnd) && (Timer1Model_run(g_modelEnd-g_modelTicks)==FALSE))
+	{
+	}
+}
+
+/*
+ * Run the main context in SysTimer_idle until the given model tick.
+ */
+static void Test_idleUntil(uint32 end)
+{
+	g_modelEnd=end;
+	while(g_modelTicks<g_modelEnd)
+	{
+		SysTimer_idle();
+	}
+}
+
+/*
+ * Call back of the accuracy checks, it records the expiry timestamp.
+ */
+static void Test_recordCallBack(void *context)
+{
+	if(g_expiryCount<(sizeof(g_expiryTime)/sizeof(g_expiryTime[0])))
+	{
+		g_expiryTime[g_expiryCount]=Timestamp_now();
+		g_expiryCount++;
+	}
+}
+
+/*
+ * Call back of a timer chain, it starts the next delay of the chain.
+ */
+static void Test_chainCallBack(void *context)
+{
+	Test_ChainType *chain=(Test_ChainType *)context;
+
+	if(chain->next<chain->count)
+	{
+		SysTimer_start(chain->id,SYS_TIMER_MS_TO_TICKS(chain->delays_ms[chain->next]),0,Test_chainCallBack,chain);
+		chain->next++;
+	}
+}
+
+/*
+ * Number of compare matches a one shot delay takes, a far deadline is reached in SYS_TIMER_MAX_DELTA hops.
+ */
+static uint32 Test_compareMatches(uint32 delay_ms)
+{
+	uint32 ticks=SYS_TIMER_MS_TO_TICKS(delay_ms);
+
+	return (ticks+SYS_TIMER_MAX_DELTA-1)/SYS_TIMER_MAX_DELTA;
+}
+
+/*
+ * A one shot timer expires at its deadline, whatever the counter phase and the delay length.
+ */
+static void Test_oneShotExpiry(void)
+{
+	static const uint32 delays[]={SYS_TIMER_MIN_DELTA,100,0xFFFF,0x10000UL,0x12345UL,SYS_TIMER_MS_TO_TICKS(15000)};
+	uint8 i;
+	uint32 start;
+
+	for(i=0;i<(sizeof(delays)/sizeof(delays[0]));i++)
+	{
+		/*Move the counter phase a little for every delay*/
+		Test_idleUntil(g_modelTicks+1000UL+(i*4099UL));
+		g_expiryCount=0;
+		start=Timestamp_now();
+		SysTimer_start((SysTimer_Id)0,delays[i],0,Test_recordCallBack,NULL_PTR);
+		Test_idleUntil(g_modelTicks+delays[i]+SYS_TIMER_MAX_DELTA);
+		TEST_CHECK_EQUAL(g_expiryCount,1);
+		TEST_CHECK_EQUAL(g_expiryTime[0]-start,delays[i]);
+	}
+}
+
+/*
+ * A periodic timer keeps its phase, and a stopped timer doesn't expire.
+ */
+static void Test_periodicExpiry(void)
+{
+	uint32 period=SYS_TIMER_MS_TO_TICKS(1000);
+	uint32 start;
+	uint8 i;
+
+	g_expiryCount=0;
+	start=Timestamp_now();
+	SysTimer_start((SysTimer_Id)0,period,period,Test_recordCallBack,NULL_PTR);
+	Test_idleUntil(g_modelTicks+(60UL*period)+(period/2));
+	SysTimer_stop((SysTimer_Id)0);
+	TEST_CHECK_EQUAL(g_expiryCount,60);
+	for(i=0;i<g_expiryCount;i++)
+	{
+		TEST_CHECK_EQUAL(g_expiryTime[i]-start,(i+1UL)*period);
+	}
+
+	Test_idleUntil(g_modelTicks+(2UL*period));
+	TEST_CHECK_EQUAL(g_expiryCount,60);
+}
+
+/*
+ * Count the wake ups of one hour idle, and of one hour with the door and lockout sequences.
+ * Idle, only the time base overflows are left. Each running timer adds its compare matches.
+ */
+static void Test_wakeupsPerHour(void)
+{
+	static const uint32 door_ms[]={15000,3000,15000};
+	static const uint32 lockout_ms[]={60000};
+	Test_ChainType door={(SysTimer_Id)0,door_ms,3,0};
+	Test_ChainType lockout={(SysTimer_Id)1,lockout_ms,1,0};
+	uint32 start;
+	uint32 idle_wakeups;
+	uint32 expected;
+	uint8 i;
+
+	/*Start at an overflow, so both runs see the same number of overflows*/
+	Test_idleUntil(g_modelTicks+(0x10000UL-TCNT1));
+	start=g_modelTicks;
+	g_wakeups=0;
+	Test_idleUntil(start+TEST_HOUR_TICKS);
+	idle_wakeups=g_wakeups;
+	TEST_CHECK_EQUAL(idle_wakeups,TEST_HOUR_TICKS/0x10000UL);
+
+	Test_idleUntil(g_modelTicks+(0x10000UL-TCNT1));
+	start=g_modelTicks;
+	g_wakeups=0;
+	Test_idleUntil(start+SYS_TIMER_MS_TO_TICKS(1000));
+	Test_chainCallBack(&door);
+	Test_idleUntil(start+SYS_TIMER_MS_TO_TICKS(100000UL));
+	Test_chainCallBack(&lockout);
+	Test_idleUntil(start+TEST_HOUR_TICKS);
+
+	expected=idle_wakeups;
+	for(i=0;i<door.count;i++)
+	{
+		expected+=Test_compareMatches(door_ms[i]);
+	}
+	expected+=Test_compareMatches(lockout_ms[0]);
+	TEST_CHECK_EQUAL(g_wakeups,expected);
+
+	printf("Timer1 tick %lu us, wake ups per hour: idle %lu, door + lockout %lu\n",
+			(unsigned long)TIMESTAMP_US_PER_TICK,(unsigned long)idle_wakeups,(unsigned long)g_wakeups);
+}
+
+int main(void)
+{
+	SREG=(1<<7);
+	Timestamp_init();
+	SysTimer_init();
+
+	Test_oneShotExpiry();
+	Test_periodicExpiry();
+	Test_wakeupsPerHour();
+
+	return TEST_RESULT("test_sys_timer");
+}